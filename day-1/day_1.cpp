@@ -7,6 +7,8 @@
 
 
 /********************************** Includes *******************************************/
+#include <charconv>
+#include <cstdint>
 #include <ostream>
 #include <iostream>
 #include <fstream>
@@ -16,6 +18,8 @@
 #include <algorithm>
 #include <numeric>
 #include <utility>
+#include "k_sum.h"
+#include "string_utilities.h"
 
 
 /*********************************** Consts ********************************************/
@@ -35,11 +39,6 @@
 
 /****************************** Functions Prototype ************************************/
 
-template <typename T>
-std::vector<std::pair<T, T>> get_pair_combinations( std::vector<T> elements );
-
-template <typename T>
-std::vector<std::vector<T>> get_triplet_combinations( std::vector<T> elements );
    /****************************** Functions Definition ***********************************/
 
 
@@ -53,66 +52,34 @@ int main( int argc, char *argv[] )
 {       
    std::vector<int> expenses;
 
-   std::ifstream password_file{ std::string{ argv[1] } };
-   std::string line;
-   while ( std::getline( password_file, line ) )
+   MappedFile expense_file = open_file( std::string{ argv[1] } );
+   for ( auto line : expense_file.lines( ) )
    {
-      expenses.push_back( std::stoi( line ) );
+      int value{ 0 };
+      std::from_chars( line.data( ), line.data( ) + line.size( ), value );
+      expenses.push_back( value );
    }
 
-   auto triplets = get_triplet_combinations( expenses );   
-   auto match = std::find_if( triplets.cbegin( ), triplets.cend( ), []( auto p ) { return ( std::accumulate(p.begin(), p.end(), 0L) == 2020 ); } );   
-   int multiple = std::accumulate( match->cbegin(), match->cend(), 1, std::multiplies<int>( ) );
-   std::cout << "match multiplication total value " << multiple << std::endl;
-
-   return 0;   
-}
-
+   /* lambda to multiply together the expenses at a set of indices */
+   auto multiply_entries = [&expenses]( const std::vector<std::size_t> &indices )
+   {
+      return std::transform_reduce( indices.cbegin( ), indices.cend( ), int64_t{ 1 }, std::multiplies<int64_t>( ), [&expenses]( std::size_t i ) { return expenses[i]; } );
+   };
 
-/**
- * @brief get all pair combinations from a vector
- * @details this returns all possible permutations of two elements in the list excluding
- *          pairs of the same item. Note, order does not matter (i.e. AB is considered equal to BA)
- * @tparam T the type of the pair
- * @param elements range of elements
- * @return vector of pairs
-*/
-template <typename T>
-std::vector<std::pair<T, T>> get_pair_combinations( std::vector<T> elements )
-{
-   std::vector<std::pair<T, T>> pairs;
-   for ( int i = 0; i < elements.size(); i++ )
+   /* part one solution */
+   auto pair = k_sum( expenses, 2020, 2 );
+   if ( pair )
    {
-      for ( int j = i+1; j < elements.size(); j++ )
-      {
-         pairs.push_back( std::pair<T, T>{ elements[i], elements[j] } );
-      }
+      std::cout << "pair multiplication total value " << multiply_entries( *pair ) << std::endl;
    }
-   return pairs;
-}
-
 
-/**
- * @brief get all triplet combinations from a vector
- * @details this returns all possible permutations of three elements in the list excluding
- *          the same item. Note, order does not matter (i.e. ABC is considered equal to BCA)
- * @tparam T the type of the pair
- * @param elements range of elements
- * @return vector of pairs
-*/
-template <typename T>
-std::vector<std::vector<T>> get_triplet_combinations(std::vector<T> elements)
-{
-   std::vector<std::vector<T>> triplets;
-   for ( int i = 0; i < elements.size( ); i++ )
+   /* part two solution */
+   auto triplet = k_sum( expenses, 2020, 3 );
+   if ( triplet )
    {
-      for ( int j = i + 1; j < elements.size( ); j++ )
-      {
-         for ( int k = j + 1; k < elements.size(); k++ )
-         {
-            triplets.push_back( { elements[i], elements[j], elements[k] } );
-         }         
-      }
+      std::cout << "match multiplication total value " << multiply_entries( *triplet ) << std::endl;
    }
-   return triplets;
-}
\ No newline at end of file
+
+   return 0;   
+}
+
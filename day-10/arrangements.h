@@ -0,0 +1,44 @@
+/*! \file arrangements.h
+*
+*  \brief count the ways a chain of adapters can be arranged
+*
+*  \author Graham Riches
+*/
+
+#pragma once
+
+/********************************** Includes *******************************************/
+#include <cstddef>
+#include <vector>
+
+/****************************** Function Definitions ***********************************/
+/**
+ * @brief count the distinct adapter chains from the first joltage to the last
+ * @details ways[i] is the number of chains that end at adapter i, which is the sum of ways[j] for every earlier adapter
+ *          j within max_step jolts. The sorted order means only a short window of earlier adapters has to be checked,
+ *          so the count is O(n * max_step) for distinct joltages and works for any mix of gaps.
+ * @tparam Count the count type. Anything with += and construction from 0 and 1, i.e. uint64_t, BigUnsigned or Modular<M>
+ * @tparam T joltage type
+ * @param joltages the joltages in ascending order, including the outlet and the device
+ * @param max_step the largest joltage difference an adapter can accept
+ * @return the number of chains from the first entry to the last, or zero if there is a gap larger than max_step
+*/
+template <typename Count, typename T>
+Count count_arrangements(const std::vector<T>& joltages, T max_step = 3)
+{
+   if (joltages.empty())
+   {
+      return Count{0};
+   }
+
+   std::vector<Count> ways(joltages.size(), Count{0});
+   ways[0] = Count{1};
+   for (std::size_t i = 1; i < joltages.size(); i++)
+   {
+      for (std::size_t j = i; (j > 0) && (joltages[i] - joltages[j - 1] <= max_step); j--)
+      {
+         ways[i] += ways[j - 1];
+      }
+   }
+   return ways.back();
+}
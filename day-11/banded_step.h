@@ -0,0 +1,94 @@
+/*! \file banded_step.h
+*
+*  \brief step a seating grid one generation at a time in bands of rows on a thread pool
+*
+*  \author Graham Riches
+*/
+
+#pragma once
+
+/********************************** Includes *******************************************/
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "seat_grid.h"
+#include "thread_pool.h"
+
+/************************************ Types ********************************************/
+/**
+ * @brief splits each generation into bands of rows and steps them on a pool
+ * @details every band reads only the current plane (its halo rows included) and writes only its own rows of the
+ *          next plane, so the bands need no locking and the only sync point is the end of the generation. Each band
+ *          reports whether it changed and the flags are OR reduced once the pool is done. A local rule only sees one
+ *          row past a band, so a band whose own rows and both neighbouring bands were stable last generation is
+ *          stable again and is carried over with a copy instead of being recomputed. A rule that can see any row
+ *          (line of sight) has every band stepped until the whole grid is stable.
+*/
+class BandedStep
+{
+public:
+   BandedStep() {};
+
+   /**
+    * @brief run one generation
+    * @tparam StepRows callable as bool(std::size_t first_row, std::size_t last_row) that writes the next generation
+    *         of those rows into the grid's back buffer and returns true if any of them change
+    * @param grid the grid. The buffers are swapped at the end
+    * @param pool the pool to run the bands on
+    * @param band_count number of bands, or zero for four per worker
+    * @param local_rule true if a cell only depends on the rows directly above and below it
+    * @param step_rows the band step
+    * @return true if any seat changed
+   */
+   template <typename StepRows>
+   bool run(SeatGrid& grid, ThreadPool& pool, std::size_t band_count, bool local_rule, StepRows&& step_rows)
+   {
+      const std::size_t row_count = grid.rows();
+      band_count = std::max<std::size_t>(1, std::min(row_count, (band_count == 0) ? pool.size() * 4 : band_count));
+      const std::size_t band_rows = std::max<std::size_t>(1, (row_count + band_count - 1) / band_count);
+      band_count = std::max<std::size_t>(1, (row_count + band_rows - 1) / band_rows);
+
+      /* flags from a different band layout or rule say nothing about which bands are stable */
+      if ((this->band_changed.size() != band_count) || !local_rule)
+      {
+         this->band_changed.assign(band_count, 1);
+      }
+      std::vector<uint8_t> changed(band_count, 0);
+
+      pool.parallel_for(band_count, [&](std::size_t band) {
+         const std::size_t first = band * band_rows;
+         const std::size_t last = std::min(row_count, (band + 1) * band_rows);
+         const bool neighbourhood_changed = this->band_changed[band] || ((band > 0) && this->band_changed[band - 1]) ||
+                                            ((band + 1 < band_count) && this->band_changed[band + 1]);
+         if (local_rule && !neighbourhood_changed)
+         {
+            grid.copy_rows_to_next(first, last);
+            return;
+         }
+         changed[band] = step_rows(first, last);
+      });
+
+      grid.swap_buffers();
+      if (local_rule)
+      {
+         this->band_changed = changed;
+      }
+      else
+      {
+         this->band_changed.clear();
+      }
+      return std::any_of(changed.begin(), changed.end(), [](uint8_t flag) { return flag != 0; });
+   }
+
+   /**
+    * @brief forget which bands were stable, i.e. after the grid was stepped some other way
+   */
+   void reset(void)
+   {
+      this->band_changed.clear();
+   }
+
+private:
+   std::vector<uint8_t> band_changed;   //!< which bands changed in the last generation run with a local rule
+};
@@ -8,17 +8,19 @@
 */
 
 /********************************** Includes *******************************************/
-#include <algorithm>
-#include <fstream>
 #include <iostream>
-#include <numeric>
 #include <ostream>
 #include <string>
 #include <vector>
+#include <algorithm>
 #include <cstdint>
 #include <map>
-#include <cmath>
-#include <functional>
+#include "banded_step.h"
+#include "incremental.h"
+#include "neighbour_table.h"
+#include "seat_grid.h"
+#include "string_utilities.h"
+#include "thread_pool.h"
 
 
 /*********************************** Consts ********************************************/
@@ -36,10 +38,8 @@ enum class LocationStatus : unsigned
 
 
 /******************************** Local Variables **************************************/
-/* store two maps (for convenience): one from char to seat location, and the other for seat location to char (debug print)*/
-static const std::map<char, LocationStatus> char_to_seat{ {'L', LocationStatus::empty}, {'#', LocationStatus::occupied}, {'.', LocationStatus::floor} };
+/* map from seat location to char (debug print) */
 static const std::map<LocationStatus, char> seat_to_char{ {LocationStatus::empty, 'L'}, {LocationStatus::occupied, '#'}, {LocationStatus::floor, '.'} };
-static const std::vector<std::pair<int, int>> view_directions{ {1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}, {0, -1}, {1, -1}};
 
 
 /******************************** Function Declarations **************************************/
@@ -49,9 +49,11 @@ static const std::vector<std::pair<int, int>> view_directions{ {1, 0}, {1, 1}, {
 /************************************ Classes ********************************************/
 struct Seats
 {
-   std::vector<std::vector<LocationStatus>> locations;
+   SeatGrid grid;
+   NeighbourTable line_of_sight;      //!< first visible seat in each direction, built once
    int rows{0};
    int columns{0};
+   BandedStep bands;                  //!< band layout and stability for the parallel iterations
 
    /**
     * @brief construct a seats struct from a file input
@@ -59,137 +61,61 @@ struct Seats
    */
    Seats(const std::string& filename)
    {      
-      std::ifstream stream{ filename };
-      std::string line;      
-      while (std::getline(stream, line))
-      {
-         std::vector<LocationStatus> row_values;
-         std::transform(line.cbegin(), line.cend(), std::back_inserter(row_values), [](const char &c){ return char_to_seat.at(c); } );         
-         this->locations.push_back( row_values );
-         this->rows++;
-      }
-      this->columns = line.length();
-   }
-
-   /**
-    * @brief tally all seats matching the selection criteria
-    * @param status the status selection
-    * @return count of seats matching the selection
-   */
-   int get_seats_by_status(LocationStatus status)
-   {
-      auto count = std::transform_reduce(this->locations.cbegin(), this->locations.cend(), 0L, std::plus<>(),
-         [status](const std::vector<LocationStatus>& row)
-         {
-            return std::count_if( row.cbegin(), row.cend(), 
-               [status]( const LocationStatus &location ){ return ( location == status);}
-            );
-         }
-      );
-      return count;
-   }
-
-   /**
-    * @brief check if a location is in bounds
-    * @param row 
-    * @param column 
-    * @return true if it's an edge
-   */
-   inline bool is_in_bounds(int row, int column)
-   {
-      bool in_bounds{true};
-      if ((row < 0) || (row >= this->rows) || (column < 0) || (column >= this->columns))
-      {
-         in_bounds = false;
-      }
-      return in_bounds;
+      MappedFile file = open_file( filename );
+      this->grid = SeatGrid::from_lines( file.lines() );
+      this->rows = static_cast<int>( this->grid.rows() );
+      this->columns = static_cast<int>( this->grid.columns() );
+      this->line_of_sight = NeighbourTable::line_of_sight( this->grid );
    }
 
    /**
-    * @brief get a vector of all neighbours to a seat
+    * @brief get the status of a location in the current generation
     * @param row the row index
     * @param column the column index
-    * @return vector of neighbours
+    * @return the status
    */
-   std::vector<LocationStatus> get_neighbours(int row, int column)
+   LocationStatus status(int row, int column) const
    {
-      std::vector<LocationStatus> neighbours;
-
-      /* ewwwww I should probably find a cleaner way to do this */
-      int row_start = ( row == 0 ) ? 0 : row - 1;
-      int col_start = ( column == 0 )? 0 : column - 1;
-      int row_end = ( row == this->rows - 1 ) ? this->rows - 1 : row + 1;
-      int col_end = ( column == this->columns - 1) ? this->columns - 1 : column + 1;
-
-      for (int i = row_start; i <= row_end; i++)
+      auto index = this->grid.index(row, column);
+      if (!this->grid.is_seat(index))
       {
-         for (int j = col_start; j <= col_end; j++)
-         {
-            if ((i != row) || (j != column))
-            {
-               neighbours.push_back(this->locations[i][j]);
-            }
-            
-         }
+         return LocationStatus::floor;
       }
-      return neighbours;
+      return this->grid.is_occupied(index) ? LocationStatus::occupied : LocationStatus::empty;
    }
 
    /**
-    * @brief get the seat status in each direction fanning out from the current location
-    * @param row_start current row
-    * @param column_start current column
-    * @return vector of what is seen in each direction
+    * @brief tally all seats matching the selection criteria
+    * @param status the status selection
+    * @return count of seats matching the selection
    */
-   std::vector<LocationStatus> count_in_all_directions(int row_start, int column_start)
+   int get_seats_by_status(LocationStatus status) const
    {
-      std::vector<LocationStatus> directions;
-      for (auto& direction : view_directions)
+      auto seats = static_cast<int>( this->grid.count_seats() );
+      auto occupied = static_cast<int>( this->grid.count_occupied() );
+      switch (status)
       {
-         int row{row_start};
-         int column{column_start};
-
-         /* loop over the view direction until either an edge is encountered, or a seat view is found */
-         while (true)
-         {
-            row += direction.first;
-            column += direction.second;
-            if (this->is_in_bounds(row, column))
-            {
-               auto status = this->locations[row][column];
-               if (status != LocationStatus::floor)
-               {
-                  directions.push_back(status);
-                  break;
-               }
-            }
-            else
-            {
-               directions.push_back(LocationStatus::floor);
-               break;
-            }
-         }
+         case LocationStatus::occupied: return occupied;
+         case LocationStatus::empty: return seats - occupied;
+         default: return (this->rows * this->columns) - seats;
       }
-      return directions;
    }
 
    /**
-    * @brief apply the rules to a vector of visible seats at a location
+    * @brief apply the rules to the number of occupied seats nearby
     * @param starting_status the initial value for a location
-    * @param seats the vector of seats
+    * @param occupied_count the number of occupied seats in range
     * @param empty_threshold how many occupied seats nearby to trigger an emptying action
-    * @return 
+    * @return the new status
    */
-   LocationStatus apply_rules(LocationStatus starting_status, std::vector<LocationStatus>& seats, int empty_threshold)
+   static LocationStatus apply_rules(LocationStatus starting_status, int occupied_count, int empty_threshold)
    {
-      auto count = std::count_if(seats.cbegin(), seats.cend(), [](auto& n) { return n == LocationStatus::occupied; });
-
       LocationStatus new_status{ starting_status };
-      if ((count >= empty_threshold) && (starting_status == LocationStatus::occupied))
+      if ((occupied_count >= empty_threshold) && (starting_status == LocationStatus::occupied))
       {
          new_status = LocationStatus::empty;
       }
-      else if ((count == 0) && (starting_status == LocationStatus::empty))
+      else if ((occupied_count == 0) && (starting_status == LocationStatus::empty))
       {
          new_status = LocationStatus::occupied;
       }
@@ -202,12 +128,10 @@ struct Seats
     * @param column the current column
     * @return new simulation status
    */
-   LocationStatus rules_part_one(int row, int column)
+   LocationStatus rules_part_one(int row, int column) const
    {
-      auto current_status = this->locations[row][column];
-      auto neighbours = this->get_neighbours(row, column);
-      
-      return this->apply_rules(current_status, neighbours, 4);
+      auto count = static_cast<int>( this->grid.adjacent_occupied(this->grid.index(row, column)) );
+      return apply_rules(this->status(row, column), count, 4);
    }
 
    /**
@@ -216,32 +140,83 @@ struct Seats
     * @param column current column
     * @return new status
    */
-   LocationStatus rules_part_two(int row, int column)
+   LocationStatus rules_part_two(int row, int column) const
    {
-      auto current_status = this->locations[row][column];
-      auto visible_seats = this->count_in_all_directions(row, column);
-      return this->apply_rules(current_status, visible_seats, 5);
+      auto seat = this->line_of_sight.seat(this->grid.index(row, column));
+      if (seat == NeighbourTable::no_seat)
+      {
+         return LocationStatus::floor;
+      }
+      auto count = static_cast<int>( this->line_of_sight.occupied_neighbours(this->grid, seat) );
+      return apply_rules(this->status(row, column), count, 5);
    }
 
+   using Rule = LocationStatus (Seats::*)(int, int) const;
+
    /**
-    * @brief run a complete iteration
-    * @note: this should really use a function pointer or something to select which rule set to call
+    * @brief work out the next generation for a band of rows, writing into the grid's back buffer
+    * @details the adjacent rule uses the grid's vectorised band step, any other rule is evaluated seat by seat
+    * @tparam rule the rule to apply at each seat
+    * @param first_row first row of the band
+    * @param last_row one past the last row of the band
+    * @return true if any seat in the band changes
    */
-   void run_iteration(void)
+   template <Rule rule>
+   bool step_rows(int first_row, int last_row)
    {
-      /* store a copy of the data and store updated locations there */
-      std::vector<std::vector<LocationStatus>> new_locations;
-
-      for (int row = 0; row < this->rows; row++)
+      if constexpr (rule == &Seats::rules_part_one)
       {
-         std::vector<LocationStatus> new_row;
-         for (int column = 0; column < this->columns; column++)
+         return this->grid.step_adjacent_rows(first_row, last_row, 4);
+      }
+      else
+      {
+         bool changed{false};
+         for (int row = first_row; row < last_row; row++)
          {
-            new_row.push_back(this->rules_part_two(row, column));
+            for (int column = 0; column < this->columns; column++)
+            {
+               auto index = this->grid.index(row, column);
+               if (!this->grid.is_seat(index))
+               {
+                  continue;
+               }
+               const bool occupied = ((this->*rule)(row, column) == LocationStatus::occupied);
+               this->grid.set_next(index, occupied);
+               changed |= (occupied != this->grid.is_occupied(index));
+            }
          }
-         new_locations.push_back(new_row);
+         return changed;
       }
-      this->locations = new_locations;
+   }
+
+   /**
+    * @brief run a complete iteration, writing into the grid's back buffer
+    * @tparam rule the rule to apply at each seat
+    * @return true if any seat changed
+   */
+   template <Rule rule = &Seats::rules_part_two>
+   bool run_iteration(void)
+   {
+      const bool changed = this->step_rows<rule>(0, this->rows);
+      this->grid.swap_buffers();
+      this->bands.reset();
+      return changed;
+   }
+
+   /**
+    * @brief run a complete iteration with the rows split into bands that are stepped on a thread pool
+    * @tparam rule the rule to apply at each seat
+    * @param pool the pool to run the bands on
+    * @param band_count number of bands, or zero for four per worker
+    * @return true if any seat changed
+   */
+   template <Rule rule = &Seats::rules_part_two>
+   bool run_iteration(ThreadPool& pool, std::size_t band_count = 0)
+   {
+      constexpr bool local_rule = (rule == &Seats::rules_part_one);
+      return this->bands.run(this->grid, pool, band_count, local_rule, [this](std::size_t first, std::size_t last) {
+         return this->step_rows<rule>(static_cast<int>( first ), static_cast<int>( last ));
+      });
    }
    
    /**
@@ -252,11 +227,11 @@ struct Seats
    */
    friend std::ostream& operator << (std::ostream& os, const Seats& seats)
    {
-      for (auto& row : seats.locations)
+      for (int row = 0; row < seats.rows; row++)
       {
-         for (auto& col : row)
+         for (int column = 0; column < seats.columns; column++)
          {
-            os << seat_to_char.at(col);
+            os << seat_to_char.at(seats.status(row, column));
          }
          os << "\n";
       }
@@ -278,21 +253,34 @@ struct Seats
 int main( int argc, char *argv[] )
 {     
    Seats seats{std::string{argv[1]}}; 
-   
-   int seats_available = seats.get_seats_by_status(LocationStatus::empty);
-   int new_seats_available{0};
-
-   /* run the simulation until it stabilizes */
-   while ( new_seats_available != seats_available )
+   const bool parallel = (argc > 2) && (std::string{ argv[2] } == "--parallel");
+   ThreadPool pool;
+
+   /* part one: step bands of rows on the pool with the vectorised adjacent seat rule until nothing changes */
+   Seats adjacent = seats;
+   while ( adjacent.run_iteration<&Seats::rules_part_one>(pool) ) {}
+   std::cout << "Occupied seat count (adjacent seats): " << adjacent.grid.count_occupied() << "\n";
+
+   /* part two: run the line of sight simulation until it stabilizes. By default only seats near the last changes are
+      revisited; --parallel steps every seat in bands on the pool instead */
+   int occupied{0};
+   if ( parallel )
+   {
+      Seats line_of_sight = seats;
+      while ( line_of_sight.run_iteration<&Seats::rules_part_two>(pool) ) {}
+      occupied = line_of_sight.get_seats_by_status(LocationStatus::occupied);
+   }
+   else
    {
-      seats_available = seats.get_seats_by_status(LocationStatus::empty);
-      seats.run_iteration();
-      new_seats_available = seats.get_seats_by_status(LocationStatus::empty);      
+      IncrementalSimulation simulation{ seats.grid, seats.line_of_sight, 5 };
+      simulation.run();
+      occupied = static_cast<int>( simulation.occupied() );
    }
+   auto floor = (seats.rows * seats.columns) - static_cast<int>( seats.line_of_sight.size() );
 
-   std::cout << "Empty seat counts: " << seats.get_seats_by_status(LocationStatus::empty) << "\n"
-             << "Occupied seat count: " << seats.get_seats_by_status(LocationStatus::occupied) << "\n"
-             << "Floor spaces: " << seats.get_seats_by_status(LocationStatus::floor) << "\n";
+   std::cout << "Empty seat counts: " << static_cast<int>( seats.line_of_sight.size() ) - occupied << "\n"
+             << "Occupied seat count: " << occupied << "\n"
+             << "Floor spaces: " << floor << "\n";
 
    return 0;
 }
@@ -0,0 +1,140 @@
+/*! \file incremental.h
+*
+*  \brief run the seating simulation by only revisiting the seats whose neighbourhood changed
+*
+*  \author Graham Riches
+*/
+
+#pragma once
+
+/********************************** Includes *******************************************/
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "neighbour_table.h"
+#include "seat_grid.h"
+
+/************************************ Types ********************************************/
+/**
+ * @brief active frontier simulation over a neighbour table
+ * @details a seat can only change if it or one of its neighbours changed in the last generation, so each generation
+ *          only evaluates the seats on a dirty worklist. Changes are worked out against the current state first and
+ *          applied afterwards so every seat still sees the same generation. Seeing is symmetric for both rule sets
+ *          (if A is B's first seat in some direction then B is A's in the opposite one), so the seats to revisit are
+ *          just the changed seat and its table neighbours. The simulation is stable once the worklist is empty, and
+ *          the occupied count is kept up to date as seats flip rather than by rescanning the grid.
+*/
+class IncrementalSimulation
+{
+public:
+   /**
+    * @brief set up a simulation starting from the current state of a grid
+    * @param grid the grid. Updated in place and must outlive the simulation
+    * @param table the neighbour table for the rule set. Must outlive the simulation
+    * @param threshold number of occupied neighbours that empties an occupied seat
+   */
+   IncrementalSimulation(SeatGrid& grid, const NeighbourTable& table, uint32_t threshold)
+      : grid(grid), table(table), threshold(threshold), queued(table.size(), 1)
+   {
+      /* every seat is dirty to begin with */
+      this->worklist.reserve(table.size());
+      for (std::size_t seat = 0; seat < table.size(); seat++)
+      {
+         this->worklist.push_back(static_cast<uint32_t>(seat));
+         this->occupied_seats += grid.is_occupied(table.cell(seat));
+      }
+   }
+
+   /**
+    * @brief check if the simulation has stopped changing
+    * @return true once no seats are left to revisit
+   */
+   bool is_stable(void) const
+   {
+      return this->worklist.empty();
+   }
+
+   std::size_t occupied(void) const
+   {
+      return this->occupied_seats;
+   }
+
+   std::size_t generations(void) const
+   {
+      return this->generation_count;
+   }
+
+   /**
+    * @brief run one generation over the dirty seats
+    * @return number of seats that changed
+   */
+   std::size_t step(void)
+   {
+      /* decide every change against the current generation before applying any of them */
+      this->changes.clear();
+      for (auto seat : this->worklist)
+      {
+         this->queued[seat] = 0;
+         const auto cell = this->table.cell(seat);
+         const bool occupied = this->grid.is_occupied(cell);
+         const uint32_t count = this->table.occupied_neighbours(this->grid, seat);
+         if (occupied ? (count >= this->threshold) : (count == 0))
+         {
+            this->changes.push_back(seat);
+         }
+      }
+
+      this->worklist.clear();
+      for (auto seat : this->changes)
+      {
+         const auto cell = this->table.cell(seat);
+         const bool occupied = !this->grid.is_occupied(cell);
+         this->grid.set(cell, occupied);
+         this->occupied_seats = occupied ? this->occupied_seats + 1 : this->occupied_seats - 1;
+
+         this->mark_dirty(seat);
+         for (auto neighbour : this->table.neighbours(seat))
+         {
+            const auto neighbour_seat = this->table.seat(neighbour);
+            if (neighbour_seat != NeighbourTable::no_seat)
+            {
+               this->mark_dirty(neighbour_seat);
+            }
+         }
+      }
+      this->generation_count += !this->changes.empty();
+      return this->changes.size();
+   }
+
+   /**
+    * @brief run generations until nothing changes
+    * @return the number of generations that changed something
+   */
+   std::size_t run(void)
+   {
+      while (!this->is_stable())
+      {
+         this->step();
+      }
+      return this->generation_count;
+   }
+
+private:
+   SeatGrid& grid;
+   const NeighbourTable& table;
+   uint32_t threshold{0};
+   std::vector<uint8_t> queued;          //!< 1 while a seat is on the worklist
+   std::vector<uint32_t> worklist;       //!< seats to evaluate next generation
+   std::vector<uint32_t> changes;        //!< seats that flip this generation
+   std::size_t occupied_seats{0};
+   std::size_t generation_count{0};
+
+   void mark_dirty(uint32_t seat)
+   {
+      if (this->queued[seat] == 0)
+      {
+         this->queued[seat] = 1;
+         this->worklist.push_back(seat);
+      }
+   }
+};
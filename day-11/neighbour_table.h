@@ -0,0 +1,206 @@
+/*! \file neighbour_table.h
+*
+*  \brief precomputed table of the seats each seat can see, so a generation is a gather and a count per seat
+*
+*  \author Graham Riches
+*/
+
+#pragma once
+
+/********************************** Includes *******************************************/
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+#include "seat_grid.h"
+
+/************************************ Types ********************************************/
+/**
+ * @brief the seats as a compact list with eight neighbour slots each
+ * @details slot k of seat s is the flat grid index of the first seat seen from s in direction k. Directions with no
+ *          seat in view point at a padding cell, which is never occupied, so a gather over all eight slots needs no
+ *          checks. The floor never changes, so the table is built once and every generation after that only touches
+ *          the seats.
+*/
+class NeighbourTable
+{
+public:
+   static constexpr std::size_t slots = 8;
+   static constexpr uint32_t no_seat = std::numeric_limits<uint32_t>::max();
+
+   NeighbourTable() {};
+
+   /**
+    * @brief build the table for the first seat visible in each direction, looking past any floor
+    * @param grid the grid
+    * @return the table
+   */
+   static NeighbourTable line_of_sight(const SeatGrid& grid)
+   {
+      return NeighbourTable{ grid, true };
+   }
+
+   /**
+    * @brief build the table for the directly adjacent seats only
+    * @param grid the grid
+    * @return the table
+   */
+   static NeighbourTable adjacent(const SeatGrid& grid)
+   {
+      return NeighbourTable{ grid, false };
+   }
+
+   /**
+    * @brief get the number of seats
+    * @return seat count
+   */
+   std::size_t size(void) const
+   {
+      return this->seat_cells.size();
+   }
+
+   /**
+    * @brief get the flat grid index of a seat
+    * @param seat the compact seat index
+    * @return the flat index
+   */
+   uint32_t cell(std::size_t seat) const
+   {
+      return this->seat_cells[seat];
+   }
+
+   /**
+    * @brief get the compact seat index at a flat grid index
+    * @param cell the flat index
+    * @return the seat index, or no_seat for floor and padding
+   */
+   uint32_t seat(std::size_t cell) const
+   {
+      return this->cell_seats[cell];
+   }
+
+   /**
+    * @brief get the neighbour slots of a seat
+    * @param seat the compact seat index
+    * @return the flat grid indices of the eight neighbours
+   */
+   std::span<const uint32_t, slots> neighbours(std::size_t seat) const
+   {
+      return std::span<const uint32_t, slots>{ this->slot_cells.data() + seat * slots, slots };
+   }
+
+   /**
+    * @brief count the occupied neighbours of a seat in the current generation
+    * @param grid the grid holding the occupancy
+    * @param seat the compact seat index
+    * @return the count (0 - 8)
+   */
+   uint32_t occupied_neighbours(const SeatGrid& grid, std::size_t seat) const
+   {
+      uint32_t count = 0;
+      for (auto neighbour : this->neighbours(seat))
+      {
+         count += grid.is_occupied(neighbour);
+      }
+      return count;
+   }
+
+private:
+   std::vector<uint32_t> seat_cells;      //!< flat index of each seat
+   std::vector<uint32_t> cell_seats;      //!< seat index of each flat cell
+   std::vector<uint32_t> slot_cells;      //!< slots per seat, seat major
+
+   /**
+    * @brief build the table
+    * @details each direction is one sweep over the grid in the order that visits a cell's neighbour in that direction
+    *          first, so "the first seat beyond the next cell" is already known when the cell is reached. That makes the
+    *          build O(cells) per direction rather than a walk to the edge from every seat.
+    * @param grid the grid
+    * @param look_past_floor true to see past floor (line of sight), false for adjacent seats only
+   */
+   NeighbourTable(const SeatGrid& grid, bool look_past_floor)
+   {
+      static constexpr std::array<std::pair<int, int>, slots> directions{ { {1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}, {0, -1}, {1, -1} } };
+      const std::size_t rows = grid.rows();
+      const std::size_t columns = grid.columns();
+      const std::size_t cells = (rows + 2) * grid.stride();
+      const uint32_t padding = 0;      //!< the top left padding cell, which is never occupied
+
+      this->cell_seats.assign(cells, no_seat);
+      for (std::size_t row = 0; row < rows; row++)
+      {
+         for (std::size_t column = 0; column < columns; column++)
+         {
+            const auto cell = grid.index(row, column);
+            if (grid.is_seat(cell))
+            {
+               this->cell_seats[cell] = static_cast<uint32_t>(this->seat_cells.size());
+               this->seat_cells.push_back(static_cast<uint32_t>(cell));
+            }
+         }
+      }
+      this->slot_cells.assign(this->seat_cells.size() * slots, padding);
+
+      /* visible[cell] = first seat seen from cell in the current direction (padding if none) */
+      std::vector<uint32_t> visible(cells, padding);
+      for (std::size_t slot = 0; slot < slots; slot++)
+      {
+         const auto [row_step, column_step] = directions[slot];
+         const auto offset = static_cast<std::ptrdiff_t>(row_step) * static_cast<std::ptrdiff_t>(grid.stride()) + column_step;
+         for (std::size_t r = 0; r < rows; r++)
+         {
+            const std::size_t row = (row_step > 0) ? rows - 1 - r : r;
+            for (std::size_t c = 0; c < columns; c++)
+            {
+               const std::size_t column = (column_step > 0) ? columns - 1 - c : c;
+               const std::size_t cell = grid.index(row, column);
+               const std::size_t next = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(cell) + offset);
+               const bool next_in_grid = (static_cast<std::size_t>(static_cast<std::ptrdiff_t>(row) + row_step) < rows) &&
+                                         (static_cast<std::size_t>(static_cast<std::ptrdiff_t>(column) + column_step) < columns);
+               uint32_t seen = padding;
+               if (next_in_grid && grid.is_seat(next))
+               {
+                  seen = static_cast<uint32_t>(next);
+               }
+               else if (next_in_grid && look_past_floor)
+               {
+                  seen = visible[next];
+               }
+               visible[cell] = seen;
+               if (this->cell_seats[cell] != no_seat)
+               {
+                  this->slot_cells[this->cell_seats[cell] * slots + slot] = seen;
+               }
+            }
+         }
+      }
+   }
+};
+
+
+/****************************** Function Definitions ***********************************/
+/**
+ * @brief run one generation over the seats in a table
+ * @param grid the grid holding the occupancy. The buffers are swapped at the end
+ * @param table the neighbour table
+ * @param threshold number of occupied neighbours that empties an occupied seat
+ * @return true if any seat changed
+*/
+inline bool step_with_table(SeatGrid& grid, const NeighbourTable& table, uint32_t threshold)
+{
+   bool changed{false};
+   for (std::size_t seat = 0; seat < table.size(); seat++)
+   {
+      const auto cell = table.cell(seat);
+      const bool occupied = grid.is_occupied(cell);
+      const uint32_t count = table.occupied_neighbours(grid, seat);
+      const bool updated = occupied ? (count < threshold) : (count == 0);
+      grid.set_next(cell, updated);
+      changed |= (updated != occupied);
+   }
+   grid.swap_buffers();
+   return changed;
+}
@@ -0,0 +1,273 @@
+/*! \file seat_grid.h
+*
+*  \brief flat, padded, double buffered seating grid with one byte per cell
+*
+*  \author Graham Riches
+*/
+
+#pragma once
+
+/********************************** Includes *******************************************/
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#   define SEAT_GRID_SSE2
+#   include <immintrin.h>
+#endif
+
+/************************************ Types ********************************************/
+/**
+ * @brief the seating layout as flat byte planes
+ * @details the layout is padded with a one cell border of floor so every cell has eight in bounds neighbours and no
+ *          edge checks are needed. A static plane marks the seats and two occupancy planes (0 or 1 per cell) are
+ *          swapped each generation, so stepping never allocates. Flat indices include the padding.
+*/
+class SeatGrid
+{
+public:
+   SeatGrid() {};
+
+   /**
+    * @brief build the grid from lines of 'L', '#' and '.'
+    * @tparam Range range of string_views (i.e. MappedFile::lines())
+    * @param lines the layout. The width is taken from the first line
+    * @return the new grid
+   */
+   template <typename Range>
+   static SeatGrid from_lines(Range&& lines)
+   {
+      std::vector<std::string_view> rows;
+      for (std::string_view line : lines)
+      {
+         rows.push_back(line);
+      }
+
+      SeatGrid grid;
+      grid.row_count = rows.size();
+      grid.column_count = rows.empty() ? 0 : rows.front().size();
+      grid.stride_size = grid.column_count + 2;
+
+      /* the slack at the end lets the vector loads run a full block past the last cell */
+      const std::size_t cells = (grid.row_count + 2) * grid.stride_size + vector_width;
+      grid.seats.assign(cells, 0);
+      grid.planes[0].assign(cells, 0);
+      grid.planes[1].assign(cells, 0);
+      for (std::size_t row = 0; row < grid.row_count; row++)
+      {
+         for (std::size_t column = 0; (column < rows[row].size()) && (column < grid.column_count); column++)
+         {
+            const char c = rows[row][column];
+            grid.seats[grid.index(row, column)] = (c == 'L') || (c == '#');
+            grid.planes[0][grid.index(row, column)] = (c == '#');
+         }
+      }
+      return grid;
+   }
+
+   std::size_t rows(void) const
+   {
+      return this->row_count;
+   }
+
+   std::size_t columns(void) const
+   {
+      return this->column_count;
+   }
+
+   /**
+    * @brief get the distance between vertically adjacent cells in the flat planes
+    * @return the row stride
+   */
+   std::size_t stride(void) const
+   {
+      return this->stride_size;
+   }
+
+   /**
+    * @brief get the flat index of a cell
+    * @param row the row
+    * @param column the column
+    * @return the index into the padded planes
+   */
+   std::size_t index(std::size_t row, std::size_t column) const
+   {
+      return (row + 1) * this->stride_size + column + 1;
+   }
+
+   bool is_seat(std::size_t index) const
+   {
+      return this->seats[index] != 0;
+   }
+
+   bool is_occupied(std::size_t index) const
+   {
+      return this->planes[this->current][index] != 0;
+   }
+
+   /**
+    * @brief set a cell's state in the current generation (for updates made in place)
+    * @param index the flat index
+    * @param occupied true if the seat is occupied
+   */
+   void set(std::size_t index, bool occupied)
+   {
+      this->planes[this->current][index] = occupied;
+   }
+
+   /**
+    * @brief set the next generation's state for a cell
+    * @param index the flat index
+    * @param occupied true if the seat will be occupied
+   */
+   void set_next(std::size_t index, bool occupied)
+   {
+      this->planes[this->current ^ 1][index] = occupied;
+   }
+
+   /**
+    * @brief carry a band of rows over to the next generation unchanged
+    * @param first_row first row of the band
+    * @param last_row one past the last row of the band
+   */
+   void copy_rows_to_next(std::size_t first_row, std::size_t last_row)
+   {
+      const std::size_t first = (first_row + 1) * this->stride_size;
+      const std::size_t last = (last_row + 1) * this->stride_size;
+      std::copy(this->planes[this->current].begin() + first, this->planes[this->current].begin() + last,
+                this->planes[this->current ^ 1].begin() + first);
+   }
+
+   /**
+    * @brief make the next generation the current one
+   */
+   void swap_buffers(void)
+   {
+      this->current ^= 1;
+   }
+
+   /**
+    * @brief count the occupied seats in the current generation
+    * @return the count
+   */
+   std::size_t count_occupied(void) const
+   {
+      std::size_t count = 0;
+      for (auto cell : this->planes[this->current])
+      {
+         count += cell;
+      }
+      return count;
+   }
+
+   /**
+    * @brief count the seats in the layout
+    * @return the count
+   */
+   std::size_t count_seats(void) const
+   {
+      std::size_t count = 0;
+      for (auto cell : this->seats)
+      {
+         count += cell;
+      }
+      return count;
+   }
+
+   /**
+    * @brief count the occupied seats directly around a cell
+    * @param index the flat index
+    * @return the count (0 - 8)
+   */
+   uint32_t adjacent_occupied(std::size_t index) const
+   {
+      const uint8_t* occupied = this->planes[this->current].data();
+      const std::size_t stride = this->stride_size;
+      return occupied[index - stride - 1] + occupied[index - stride] + occupied[index - stride + 1] + occupied[index - 1] +
+             occupied[index + 1] + occupied[index + stride - 1] + occupied[index + stride] + occupied[index + stride + 1];
+   }
+
+   /**
+    * @brief work out the next generation for a band of rows with the adjacent seat rule
+    * @details the eight neighbour counts for a block of cells are the sum of eight unaligned loads of the occupancy
+    *          plane shifted by one row and/or column, so a whole block of cells is counted and updated with a handful
+    *          of byte wide vector operations. Only the current plane is read and only the next plane is written, so
+    *          bands can be stepped independently.
+    * @param first_row first row of the band
+    * @param last_row one past the last row of the band
+    * @param threshold number of occupied neighbours that empties an occupied seat
+    * @return true if any cell in the band changes
+   */
+   bool step_adjacent_rows(std::size_t first_row, std::size_t last_row, uint8_t threshold = 4)
+   {
+      const uint8_t* occupied = this->planes[this->current].data();
+      uint8_t* next = this->planes[this->current ^ 1].data();
+      const uint8_t* seat = this->seats.data();
+      const std::size_t stride = this->stride_size;
+      uint32_t changed = 0;
+
+      for (std::size_t row = first_row; row < last_row; row++)
+      {
+         std::size_t column = 0;
+#if defined(SEAT_GRID_SSE2)
+         const __m128i zero = _mm_setzero_si128();
+         const __m128i one = _mm_set1_epi8(1);
+         const __m128i limit = _mm_set1_epi8(static_cast<char>(threshold));
+         __m128i difference = zero;
+         for (; column + vector_width <= this->column_count; column += vector_width)
+         {
+            const std::size_t cell = this->index(row, column);
+            auto load = [occupied](std::size_t at) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(occupied + at)); };
+            __m128i sum = _mm_add_epi8(_mm_add_epi8(load(cell - stride - 1), load(cell - stride)), load(cell - stride + 1));
+            sum = _mm_add_epi8(sum, _mm_add_epi8(load(cell - 1), load(cell + 1)));
+            sum = _mm_add_epi8(sum, _mm_add_epi8(_mm_add_epi8(load(cell + stride - 1), load(cell + stride)), load(cell + stride + 1)));
+
+            /* empty seats fill when nothing is around them, occupied seats stay while below the threshold */
+            const __m128i current_cells = load(cell);
+            const __m128i is_empty = _mm_cmpeq_epi8(current_cells, zero);
+            const __m128i fills = _mm_and_si128(is_empty, _mm_cmpeq_epi8(sum, zero));
+            const __m128i stays = _mm_andnot_si128(is_empty, _mm_cmplt_epi8(sum, limit));
+            const __m128i seats_block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(seat + cell));
+            const __m128i updated = _mm_and_si128(_mm_and_si128(_mm_or_si128(fills, stays), one), seats_block);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(next + cell), updated);
+            difference = _mm_or_si128(difference, _mm_xor_si128(updated, current_cells));
+         }
+         changed |= static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(difference, zero)) != 0xFFFF);
+#endif
+         for (; column < this->column_count; column++)
+         {
+            const std::size_t cell = this->index(row, column);
+            const uint32_t count = this->adjacent_occupied(cell);
+            const uint8_t updated = seat[cell] & static_cast<uint8_t>(occupied[cell] ? (count < threshold) : (count == 0));
+            next[cell] = updated;
+            changed |= static_cast<uint32_t>(updated != occupied[cell]);
+         }
+      }
+      return changed != 0;
+   }
+
+   /**
+    * @brief run one generation of the whole grid with the adjacent seat rule
+    * @param threshold number of occupied neighbours that empties an occupied seat
+    * @return true if any seat changed
+   */
+   bool step_adjacent(uint8_t threshold = 4)
+   {
+      const bool changed = this->step_adjacent_rows(0, this->row_count, threshold);
+      this->swap_buffers();
+      return changed;
+   }
+
+private:
+   static constexpr std::size_t vector_width = 16;
+   std::size_t row_count{0};
+   std::size_t column_count{0};
+   std::size_t stride_size{0};
+   std::vector<uint8_t> seats;                  //!< 1 where there is a seat, never changes
+   std::vector<uint8_t> planes[2];              //!< occupancy double buffer
+   std::size_t current{0};                      //!< which plane holds the current generation
+};
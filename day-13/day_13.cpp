@@ -18,6 +18,7 @@
 #include <regex>
 #include <cmath>
 #include <cstdint>
+#include "string_utilities.h"
 
 
 /*********************************** Consts ********************************************/
@@ -47,41 +48,6 @@ struct BusScheduler
 
 
 /******************************** Function Declarations **************************************/
-/**
-    * @brief stript a substring out of the string
-    * @input the input string
-    * @param substring the substring to split
-    * @return reference to self
-   */
-inline std::string& strip(std::string &input, const std::string& substring)
-{
-   size_t substring_pos = std::string::npos;
-   while ((substring_pos = input.find(substring)) != std::string::npos)
-   {
-      input.erase(substring_pos, substring.length());
-   }
-   return input;
-}
-
-/**
- * @brief split a string object into sub strings based on a delimiter string
- * @param input the input string object
- * @param substring to split by
- * @return vector of strings
-*/
-inline std::vector<std::string> split(std::string &input, const std::string& substring)
-{
-   std::vector<std::string> list;
-   size_t substring_pos = std::string::npos;
-   while ((substring_pos = input.find(substring)) != std::string::npos)
-   {
-      list.push_back(input.substr(0, substring_pos));
-      input.erase(0, substring_pos + substring.length());
-   }
-   list.push_back(input.substr(0, input.length()));
-   return list;
-}
-
 /**
  * @brief function to load the data into a collection
  * @param filename filename to read input from
@@ -38,18 +38,20 @@
 template <class Cube_N>
 std::set<Cube_N> get_input_set(const std::string& filename)
 {
-   std::vector<std::string> lines = read_file(open_file(filename));
+   MappedFile file = open_file(filename);
    
    std::set<Cube_N> set;
-   for (int row = 0; row < lines.size(); row++)
+   int row = 0;
+   for (auto line : file.lines())
    {
-      for (int column = 0; column < lines[row].size(); column++ )
+      for (int column = 0; column < line.size(); column++ )
       {
-         if (lines[row][column] == '#')
+         if (line[column] == '#')
          {
             set.insert( Cube_N{row, column});
          }
       }      
+      row++;
    }
    return set;
 }
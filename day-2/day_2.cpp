@@ -7,12 +7,17 @@
 
 /********************************** Includes *******************************************/
 #include <algorithm>
+#include <charconv>
 #include <fstream>
 #include <iostream>
 #include <numeric>
+#include <optional>
 #include <regex>
 #include <string>
+#include <string_view>
 #include <vector>
+#include "password_batch.h"
+#include "string_utilities.h"
 
 /*********************************** Consts ********************************************/
 
@@ -39,17 +44,43 @@ class PasswordWithPolicy
    /**
     * @brief factory method to create a new password object from a string
     * @param input the input string
-    * @return new password object
-    * @note there is absolutely no error checking here, and some dubious hard-coding
+    * @return new password object, or nullopt if the line isn't a "min-max letter: password" record
+    * @note this is much slower than PasswordBatch::parse, but is kept as the reference to check the batch parser against
    */
-   static PasswordWithPolicy from_string( const std::string &input )
+   static std::optional<PasswordWithPolicy> from_string( const std::string &input )
    {
-      std::basic_regex password_policy{ "(\\d+)-(\\d+) ([a-z]): ([a-z]+)", std::regex::icase };
+      static const std::regex password_policy{ "(\\d+)-(\\d+) ([a-z]): ([a-z]+)", std::regex::icase };
       std::smatch matches;
-      std::regex_search( input, matches, password_policy );
+      if ( !std::regex_match( input, matches, password_policy ) )
+      {
+         return std::nullopt;
+      }
+
+      /* from_chars rather than stoi so a count too big for an int is a rejected line instead of an exception */
+      int min_count{ 0 };
+      int max_count{ 0 };
+      auto to_int = []( const std::ssub_match &match, int &value ) {
+         return std::from_chars( &*match.first, &*match.first + match.length( ), value ).ec == std::errc{ };
+      };
+      if ( !to_int( matches[1], min_count ) || !to_int( matches[2], max_count ) )
+      {
+         return std::nullopt;
+      }
+      return PasswordWithPolicy( std::string( matches[3] )[0], min_count, max_count, std::string( matches[4] ) );
+   }
 
-      PasswordWithPolicy new_password( std::string( matches[3] )[0], std::stoi( matches[1] ), std::stoi( matches[2] ), std::string( matches[4] ) );
-      return new_password;
+   /**
+    * @brief check if the password object holds exactly these fields
+    * @param letter policy letter
+    * @param min_count first policy number
+    * @param max_count second policy number
+    * @param other_password the password
+    * @return true if every field matches
+   */
+   bool has_fields( char letter, int min_count, int max_count, std::string_view other_password ) const
+   {
+      return ( this->policy_letter == letter ) && ( this->min_policy_count == min_count ) && ( this->max_policy_count == max_count ) &&
+             ( this->password == other_password );
    }
 
    /**
@@ -93,6 +124,46 @@ class PasswordWithPolicy
 
 
 /****************************** Functions Definition ***********************************/
+/**
+ * @brief differential test of the batch parser and validator against the regex parser and password objects
+ * @details every line is run through the batch scanner on its own, so a line is skipped here exactly when
+ *          PasswordBatch::parse skipped it and the record indices stay lined up with the batch
+ * @param batch the parsed batch
+ * @param file the file the batch was parsed from
+ * @return the (1 based) numbers of the lines where the two disagree, including lines only one of them accepts
+*/
+std::vector<std::size_t> verify_against_reference( const PasswordBatch &batch, const MappedFile &file )
+{
+   std::vector<std::size_t> mismatches;
+   std::size_t index = 0;
+   std::size_t line_number = 0;
+   for ( auto line : file.lines( ) )
+   {
+      line_number++;
+      const PasswordBatch record = PasswordBatch::parse( line );
+      const auto reference = PasswordWithPolicy::from_string( std::string{ line } );
+      if ( record.size( ) == 0 )
+      {
+         if ( reference.has_value( ) )
+         {
+            mismatches.push_back( line_number );
+         }
+         continue;
+      }
+
+      const bool matches = reference.has_value( ) && ( index < batch.size( ) ) &&
+                           reference->has_fields( batch.letters[index], batch.min_counts[index], batch.max_counts[index], batch.password( index ) ) &&
+                           ( validate_record( batch, index ) == std::pair<bool, bool>{ reference->is_valid( ), reference->is_valid_from_new_arbitrary_rules( ) } );
+      if ( !matches )
+      {
+         mismatches.push_back( line_number );
+      }
+      index++;
+   }
+   return mismatches;
+}
+
+
 /**
  * @brief main application entry point
  * @param argc number of arguments
@@ -101,27 +172,30 @@ class PasswordWithPolicy
 */
 int main( int argc, char *argv[] )
 {
-   /* read the input stream into a vector of password objects */
-   std::vector<PasswordWithPolicy> passwords;
+   /* parse the mapped input into a column store */
+   MappedFile password_file = open_file( std::string{ argv[1] } );
+   PasswordBatch batch = PasswordBatch::parse( password_file.view( ) );
 
-   std::ifstream password_file{ std::string{ argv[1] } };
-   std::string line;
-   while ( std::getline( password_file, line ) )
+   /* optionally check the fast parser against the regex one */
+   if ( ( argc > 2 ) && ( std::string{ argv[2] } == "--verify" ) )
    {
-      passwords.push_back( PasswordWithPolicy::from_string( line ) );
+      auto mismatches = verify_against_reference( batch, password_file );
+      std::cout << "batch parser and validator match the reference: " << std::boolalpha << mismatches.empty( ) << std::endl;
+      for ( auto line : mismatches )
+      {
+         std::cout << "   mismatch on line " << line << std::endl;
+      }
    }
 
+   /* validate both rule sets in one pass over the batch */
+   PolicyCounts valid_passwords = validate_batch( batch );
 
    /* part 1 solution */
-   auto valid_passwords_part_1 = std::transform_reduce(
-      passwords.cbegin( ), passwords.cend( ), 0L, std::plus<>( ), []( const PasswordWithPolicy &pass ) { return pass.is_valid( ); } );
-   std::cout << "Number of passwords valid from initial rules: " << valid_passwords_part_1 << std::endl;
+   std::cout << "Number of passwords valid from initial rules: " << valid_passwords.count_rule << std::endl;
 
 
    /* part 2 solution */
-   auto valid_passwords_part_2 = std::transform_reduce(
-      passwords.cbegin( ), passwords.cend( ), 0L, std::plus<>( ), []( const PasswordWithPolicy &pass ) { return pass.is_valid_from_new_arbitrary_rules( ); } );
-   std::cout << "Number of valid passwords from aribitrary rules: " << valid_passwords_part_2 << std::endl;
+   std::cout << "Number of valid passwords from aribitrary rules: " << valid_passwords.position_rule << std::endl;
 
    return 0;
 }
@@ -0,0 +1,224 @@
+/*! \file password_batch.h
+*
+*  \brief column store of password policy records parsed straight out of the input buffer
+*
+*  \author Graham Riches
+*/
+
+#pragma once
+
+/********************************** Includes *******************************************/
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#   include <immintrin.h>
+#endif
+
+/************************************ Types ********************************************/
+/**
+ * @brief structure of arrays holding every "min-max letter: password" record in a buffer. Passwords are not
+ *        copied: each one is an offset and length into the original buffer, which must outlive the batch
+*/
+struct PasswordBatch
+{
+   std::string_view buffer;
+   std::vector<int32_t> min_counts;
+   std::vector<int32_t> max_counts;
+   std::vector<char> letters;
+   std::vector<uint64_t> offsets;
+   std::vector<uint32_t> lengths;
+
+   /**
+    * @brief get the number of records in the batch
+    * @return record count
+   */
+   std::size_t size(void) const
+   {
+      return this->letters.size();
+   }
+
+   /**
+    * @brief get the password for a record
+    * @param index the record index
+    * @return view of the password in the original buffer
+   */
+   std::string_view password(std::size_t index) const
+   {
+      return this->buffer.substr(this->offsets[index], this->lengths[index]);
+   }
+
+   /**
+    * @brief parse every record in a buffer with a hand written scanner (no regex, no allocation per record)
+    * @param buffer the raw input, one record per line
+    * @return the filled batch
+    * @note lines that don't match the record layout are skipped
+   */
+   static PasswordBatch parse(std::string_view buffer)
+   {
+      PasswordBatch batch;
+      batch.buffer = buffer;
+
+      /* rough guess at the record count so the columns don't keep reallocating */
+      const std::size_t expected_records = buffer.size() / 24 + 1;
+      batch.min_counts.reserve(expected_records);
+      batch.max_counts.reserve(expected_records);
+      batch.letters.reserve(expected_records);
+      batch.offsets.reserve(expected_records);
+      batch.lengths.reserve(expected_records);
+
+      const char* const begin = buffer.data();
+      const char* const end = begin + buffer.size();
+      const char* position = begin;
+      while (position < end)
+      {
+         auto newline = static_cast<const char*>(std::memchr(position, '\n', static_cast<std::size_t>(end - position)));
+         const char* line_end = (newline != nullptr) ? newline : end;
+         batch.parse_record(begin, position, line_end);
+         position = (newline != nullptr) ? newline + 1 : end;
+      }
+      return batch;
+   }
+
+private:
+   /**
+    * @brief parse a single line and append it to the columns if it is well formed
+    * @param begin start of the whole buffer (for offsets)
+    * @param position start of the line
+    * @param line_end one past the end of the line
+   */
+   void parse_record(const char* begin, const char* position, const char* line_end)
+   {
+      if ((line_end > position) && (*(line_end - 1) == '\r'))
+      {
+         line_end--;
+      }
+
+      int32_t min_count{0};
+      int32_t max_count{0};
+      auto [after_min, min_error] = std::from_chars(position, line_end, min_count);
+      if ((min_error != std::errc{}) || (after_min == line_end) || (*after_min != '-'))
+      {
+         return;
+      }
+      auto [after_max, max_error] = std::from_chars(after_min + 1, line_end, max_count);
+
+      /* the rest of the line is always " x: password" */
+      if ((max_error != std::errc{}) || ((line_end - after_max) < 4) || (after_max[0] != ' ') || (after_max[2] != ':') || (after_max[3] != ' '))
+      {
+         return;
+      }
+      const char* password = after_max + 4;
+
+      this->min_counts.push_back(min_count);
+      this->max_counts.push_back(max_count);
+      this->letters.push_back(after_max[1]);
+      this->offsets.push_back(static_cast<uint64_t>(password - begin));
+      this->lengths.push_back(static_cast<uint32_t>(line_end - password));
+   }
+};
+
+
+/**
+ * @brief tally of valid records under each rule set
+*/
+struct PolicyCounts
+{
+   int64_t count_rule{0};      //!< letter count between min and max (part one)
+   int64_t position_rule{0};   //!< letter at exactly one of the two positions (part two)
+};
+
+
+/****************************** Function Definitions ***********************************/
+/**
+ * @brief count how many times a letter appears in a password with byte compares (AVX2, then SSE2, then scalar)
+ * @param data start of the password
+ * @param length password length
+ * @param readable number of bytes that can safely be read from data. The vector loads read whole blocks and mask
+ *        off anything past the password, so they are only used while a whole block fits in the buffer
+ * @param letter the letter to count
+ * @return the count
+*/
+inline uint32_t count_letter(const char* data, std::size_t length, std::size_t readable, char letter)
+{
+   uint32_t count{0};
+   std::size_t i = 0;
+#if defined(__AVX2__)
+   const __m256i needle = _mm256_set1_epi8(letter);
+   for (; (i < length) && (i + 32 <= readable); i += 32)
+   {
+      const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+      uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle)));
+      if (length - i < 32)
+      {
+         mask &= (uint32_t{1} << (length - i)) - 1;
+      }
+      count += static_cast<uint32_t>(std::popcount(mask));
+   }
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+   const __m128i needle = _mm_set1_epi8(letter);
+   for (; (i < length) && (i + 16 <= readable); i += 16)
+   {
+      const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+      uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+      if (length - i < 16)
+      {
+         mask &= (uint32_t{1} << (length - i)) - 1;
+      }
+      count += static_cast<uint32_t>(std::popcount(mask));
+   }
+#endif
+   for (; i < length; i++)
+   {
+      count += (data[i] == letter);
+   }
+   return count;
+}
+
+/**
+ * @brief check a single record in the batch against both rule sets
+ * @param batch the batch
+ * @param index the record index
+ * @return pair of (count rule valid, position rule valid)
+ * @note positions past the end of the password never match
+*/
+inline std::pair<bool, bool> validate_record(const PasswordBatch& batch, std::size_t index)
+{
+   const uint64_t offset = batch.offsets[index];
+   const uint32_t length = batch.lengths[index];
+   const char letter = batch.letters[index];
+   const char* password = batch.buffer.data() + offset;
+
+   const int64_t count = count_letter(password, length, batch.buffer.size() - offset, letter);
+   const bool count_valid = (count >= batch.min_counts[index]) && (count <= batch.max_counts[index]);
+
+   auto letter_at = [password, length, letter](int32_t position)
+   {
+      return (position >= 1) && (static_cast<uint32_t>(position) <= length) && (password[position - 1] == letter);
+   };
+   const bool position_valid = letter_at(batch.min_counts[index]) != letter_at(batch.max_counts[index]);
+   return { count_valid, position_valid };
+}
+
+/**
+ * @brief validate every record in a batch against both rule sets in a single pass
+ * @param batch the batch
+ * @return number of records valid under each rule set
+*/
+inline PolicyCounts validate_batch(const PasswordBatch& batch)
+{
+   PolicyCounts counts;
+   for (std::size_t i = 0; i < batch.size(); i++)
+   {
+      auto [count_valid, position_valid] = validate_record(batch, i);
+      counts.count_rule += count_valid;
+      counts.position_rule += position_valid;
+   }
+   return counts;
+}
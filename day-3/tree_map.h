@@ -0,0 +1,151 @@
+/*! \file tree_map.h
+*
+*  \brief bit packed map of the trees in the forest
+*
+*  \author Graham Riches
+*/
+
+#pragma once
+
+/********************************** Includes *******************************************/
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/************************************ Types ********************************************/
+/**
+ * @brief map of the forest stored as one contiguous row-major bitmap (1 = tree). Each row is padded to a whole
+ *        number of 64 bit words so a row can be indexed without any shifting across rows
+*/
+class TreeMap
+{
+public:
+   TreeMap() {};
+
+   /**
+    * @brief build the map from lines of '.' and '#'
+    * @tparam Range range of string_views (i.e. MappedFile::lines())
+    * @param lines the lines of the map. The width is taken from the first line
+    * @return the new map
+   */
+   template <typename Range>
+   static TreeMap from_lines(Range&& lines)
+   {
+      TreeMap map;
+      for (std::string_view line : lines)
+      {
+         if (map.row_count == 0)
+         {
+            map.column_count = line.size();
+            map.words_per_row = (map.column_count + 63) / 64;
+         }
+         map.bits.resize(map.bits.size() + map.words_per_row);
+         uint64_t* row = map.bits.data() + (map.row_count * map.words_per_row);
+         for (std::size_t column = 0; (column < line.size()) && (column < map.column_count); column++)
+         {
+            row[column >> 6] |= static_cast<uint64_t>(line[column] == '#') << (column & 63);
+         }
+         map.row_count++;
+      }
+      return map;
+   }
+
+   std::size_t rows(void) const
+   {
+      return this->row_count;
+   }
+
+   std::size_t columns(void) const
+   {
+      return this->column_count;
+   }
+
+   /**
+    * @brief get a pointer to the packed words for a row
+    * @param row the row index
+    * @return pointer to the first word of the row
+   */
+   const uint64_t* row_bits(std::size_t row) const
+   {
+      return this->bits.data() + (row * this->words_per_row);
+   }
+
+   /**
+    * @brief check if there is a tree at a location
+    * @param row the row
+    * @param column the column (must already be wrapped to the map width)
+    * @return true if there is a tree
+   */
+   bool is_tree(std::size_t row, std::size_t column) const
+   {
+      return (this->row_bits(row)[column >> 6] >> (column & 63)) & 1;
+   }
+
+private:
+   std::size_t row_count{0};
+   std::size_t column_count{0};
+   std::size_t words_per_row{0};
+   std::vector<uint64_t> bits;
+};
+
+
+/**
+ * @brief count the trees hit on many slopes with a single pass over the rows of the map
+ * @details the slopes are kept as a structure of arrays and every slope is stepped on every row with masks
+ *          rather than branches (a slope that skips a row just adds zero), so the inner loop is straight line
+ *          code over contiguous arrays that the compiler can vectorise. The map is read once no matter how
+ *          many slopes are queried.
+ * @param map the tree map
+ * @param slopes vector of (over, down) slopes. over may be negative (moving left); down must be at least 1
+ * @return trees hit for each slope
+ * @throws std::invalid_argument if any slope has down <= 0, which would never leave the first row
+*/
+inline std::vector<int64_t> count_on_paths(const TreeMap& map, const std::vector<std::pair<int, int>>& slopes)
+{
+   const std::size_t count = slopes.size();
+   const uint64_t columns = map.columns();
+   std::vector<uint64_t> overs(count);
+   std::vector<uint64_t> downs(count);
+   std::vector<uint64_t> column(count, 0);
+   std::vector<uint64_t> next_row(count, 0);
+   std::vector<int64_t> trees(count, 0);
+   for (std::size_t s = 0; s < count; s++)
+   {
+      const auto [over, down] = slopes[s];
+      if (down <= 0)
+      {
+         throw std::invalid_argument("slope must move down at least one row");
+      }
+
+      /* reduce in signed arithmetic so a slope moving left wraps to the equivalent step to the right */
+      const auto width = static_cast<int64_t>(columns);
+      overs[s] = (columns > 0) ? static_cast<uint64_t>(((over % width) + width) % width) : 0;
+      downs[s] = static_cast<uint64_t>(down);
+   }
+
+   if (columns == 0)
+   {
+      return trees;
+   }
+
+   for (uint64_t row = 0; row < map.rows(); row++)
+   {
+      const uint64_t* bits = map.row_bits(row);
+      for (std::size_t s = 0; s < count; s++)
+      {
+         const uint64_t active = (next_row[s] == row);
+         const uint64_t tree = (bits[column[s] >> 6] >> (column[s] & 63)) & 1;
+         trees[s] += static_cast<int64_t>(tree & active);
+
+         /* step the slope forward only on rows it lands on, wrapping without a modulo */
+         uint64_t next_column = column[s] + (overs[s] & (0 - active));
+         next_column -= columns & (0 - static_cast<uint64_t>(next_column >= columns));
+         column[s] = next_column;
+         next_row[s] += downs[s] & (0 - active);
+      }
+   }
+   return trees;
+}
@@ -0,0 +1,235 @@
+/*! \file passport.h
+*
+*  \brief passport records tokenized in a single scan and checked against the field rules
+*
+*  \author Graham Riches
+*/
+
+#pragma once
+
+/********************************** Includes *******************************************/
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+/************************************ Types ********************************************/
+enum class PassportFields : unsigned
+{
+   id,
+   country_id,
+   birth_year,
+   issue_year,
+   expiration_year,
+   height,
+   hair_color,
+   eye_color
+};
+
+static constexpr std::size_t passport_field_count = 8;
+
+/**
+ * @brief the 3 character key for each field, in PassportFields order
+*/
+static constexpr std::array<std::string_view, passport_field_count> passport_field_keys{ "pid", "cid", "byr", "iyr", "eyr", "hgt", "hcl", "ecl" };
+
+/**
+ * @brief pack a 3 byte field key into an integer so keys can be dispatched with a switch
+ * @param key the key (at least 3 characters)
+ * @return packed key
+*/
+constexpr uint32_t pack_key(std::string_view key)
+{
+   return static_cast<uint32_t>(static_cast<unsigned char>(key[0])) | (static_cast<uint32_t>(static_cast<unsigned char>(key[1])) << 8) |
+          (static_cast<uint32_t>(static_cast<unsigned char>(key[2])) << 16);
+}
+
+/**
+ * @brief look up the field for a key
+ * @param key the key
+ * @return the field index, or passport_field_count for an unknown key
+*/
+constexpr std::size_t field_from_key(std::string_view key)
+{
+   switch (pack_key(key))
+   {
+      case pack_key("pid"): return static_cast<std::size_t>(PassportFields::id);
+      case pack_key("cid"): return static_cast<std::size_t>(PassportFields::country_id);
+      case pack_key("byr"): return static_cast<std::size_t>(PassportFields::birth_year);
+      case pack_key("iyr"): return static_cast<std::size_t>(PassportFields::issue_year);
+      case pack_key("eyr"): return static_cast<std::size_t>(PassportFields::expiration_year);
+      case pack_key("hgt"): return static_cast<std::size_t>(PassportFields::height);
+      case pack_key("hcl"): return static_cast<std::size_t>(PassportFields::hair_color);
+      case pack_key("ecl"): return static_cast<std::size_t>(PassportFields::eye_color);
+      default: return passport_field_count;
+   }
+}
+
+/**
+ * @brief check if a character separates passport fields
+ * @param c the character
+ * @return true for whitespace
+*/
+constexpr bool is_field_separator(char c)
+{
+   return (c == ' ') || (c == '\n') || (c == '\r') || (c == '\t');
+}
+
+
+class Passport
+{
+private:
+   std::array<std::string_view, passport_field_count> fields;
+   Passport() {};
+
+   /**
+    * @brief get a field value
+    * @param field the field
+    * @return view of the value (empty if not present)
+   */
+   std::string_view field(PassportFields field) const
+   {
+      return this->fields[static_cast<std::size_t>(field)];
+   }
+
+   /**
+    * @brief parse a field that must be exactly four digits into a year
+    * @param field the field
+    * @return the year, or 0 if it isn't four digits
+   */
+   int year(PassportFields field) const
+   {
+      auto value = this->field(field);
+      int year{0};
+      auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), year);
+      return ( (value.size() == 4) && (error == std::errc{}) && (end == value.data() + value.size()) ) ? year : 0;
+   }
+
+   /**
+    * @brief check the height is a number followed by cm (150 - 193) or in (59 - 76)
+    * @return true if valid
+   */
+   bool valid_height(void) const
+   {
+      auto value = this->field(PassportFields::height);
+      int height{0};
+      auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), height);
+      const std::string_view unit{ end, static_cast<std::size_t>(value.data() + value.size() - end) };
+      if ((error != std::errc{}) || (end == value.data()))
+      {
+         return false;
+      }
+      return ((unit == "cm") && (height >= 150) && (height <= 193)) || ((unit == "in") && (height >= 59) && (height <= 76));
+   }
+
+   /**
+    * @brief check the hair colour is a '#' followed by exactly six lower case hex digits
+    * @return true if valid
+   */
+   bool valid_hair_color(void) const
+   {
+      auto value = this->field(PassportFields::hair_color);
+      return (value.size() == 7) && (value[0] == '#') &&
+             std::all_of(value.begin() + 1, value.end(), [](char c){ return ((c >= '0') && (c <= '9')) || ((c >= 'a') && (c <= 'f')); });
+   }
+
+   /**
+    * @brief check the passport id is exactly nine digits (leading zeros included)
+    * @return true if valid
+   */
+   bool valid_id(void) const
+   {
+      auto value = this->field(PassportFields::id);
+      return (value.size() == 9) && std::all_of(value.begin(), value.end(), [](char c){ return (c >= '0') && (c <= '9'); });
+   }
+
+public:   
+   /**
+    * @brief factory method to create a passport object from a record in a single scan
+    * @param input the record: whitespace separated key:value pairs. Must outlive the passport as fields are views into it
+    * @return new passport object
+   */
+   static Passport from_string(std::string_view input)
+   {
+      Passport new_passport;
+      std::size_t position = 0;
+      while (position < input.size())
+      {
+         /* skip to the start of the next token and find the end of it */
+         while ((position < input.size()) && is_field_separator(input[position]))
+         {
+            position++;
+         }
+         std::size_t token_end = position;
+         while ((token_end < input.size()) && !is_field_separator(input[token_end]))
+         {
+            token_end++;
+         }
+
+         /* every token is "key:value" with a three byte key */
+         if ((token_end - position > 4) && (input[position + 3] == ':'))
+         {
+            auto field = field_from_key(input.substr(position, 3));
+            if (field < passport_field_count)
+            {
+               new_passport.fields[field] = input.substr(position + 4, token_end - position - 4);
+            }
+         }
+         position = token_end;
+      }
+      return new_passport;
+   }
+
+   /**
+    * @brief check that a passport object contains all of the fields present in an input list
+    * @param check_fields the fields to check
+    * @return true if all fields are non-null
+   */
+   bool check_contains(const std::vector<PassportFields>& check_fields) const
+   {
+      return std::all_of( cbegin(check_fields), cend(check_fields), [this](PassportFields field){ return !this->field(field).empty(); } );
+   }
+
+   /**
+    * @brief check if a passport's field values are valid based on the criteria
+    * @return true/false
+    * @note a missing field is empty, which no rule accepts, so this also fails passports missing a required field
+   */
+   bool validate_all_fields( void ) const
+   {   
+      static constexpr std::array<std::string_view, 7> valid_eye_colors{ "amb", "blu", "brn", "gry", "grn", "hzl", "oth" };
+      const int birth_year = this->year(PassportFields::birth_year);
+      const int issue_year = this->year(PassportFields::issue_year);
+      const int expiration_year = this->year(PassportFields::expiration_year);
+
+      return ((birth_year >= 1920) && (birth_year <= 2002)) &&
+             ((issue_year >= 2010) && (issue_year <= 2020)) &&
+             ((expiration_year >= 2020) && (expiration_year <= 2030)) &&
+             this->valid_height() && this->valid_hair_color() && this->valid_id() &&
+             (std::find(cbegin(valid_eye_colors), cend(valid_eye_colors), this->field(PassportFields::eye_color)) != cend(valid_eye_colors));
+   }
+
+   friend std::ostream& operator << (std::ostream& os, const Passport& pass)
+   {
+      for (std::size_t i = 0; i < passport_field_count; i++)
+      {
+         os << passport_field_keys[i] << " : " << pass.fields[i] << "\n";
+      }
+      os << "\n";
+      return os;
+   }
+
+};
+
+
+/*********************************** Consts ********************************************/
+/**
+ * @brief the fields every passport needs. The country id is optional
+*/
+inline const std::vector<PassportFields> required_passport_fields{ PassportFields::id, PassportFields::birth_year, PassportFields::issue_year,
+                                                                   PassportFields::expiration_year, PassportFields::height, PassportFields::hair_color,
+                                                                   PassportFields::eye_color };
@@ -0,0 +1,111 @@
+/*! \file boarding_pass.h
+*
+*  \brief branch free boarding pass decoding
+*
+*  \author Graham Riches
+*/
+
+#pragma once
+
+/********************************** Includes *******************************************/
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#   define BOARDING_PASS_SSE2
+#   include <immintrin.h>
+#endif
+
+/*********************************** Consts ********************************************/
+/**
+ * @brief number of characters in a boarding pass: 7 row characters then 3 column characters
+*/
+static constexpr std::size_t pass_length = 10;
+
+/**
+ * @brief number of possible seat ids (10 bits)
+*/
+static constexpr std::size_t seat_count = 1 << pass_length;
+
+/**
+ * @brief table that reverses the order of the low 10 bits of an index
+*/
+static constexpr std::array<uint16_t, seat_count> reversed_bits = []()
+{
+   std::array<uint16_t, seat_count> table{};
+   for (std::size_t i = 0; i < seat_count; i++)
+   {
+      uint16_t reversed{0};
+      for (std::size_t bit = 0; bit < pass_length; bit++)
+      {
+         reversed |= static_cast<uint16_t>(((i >> bit) & 1) << (pass_length - 1 - bit));
+      }
+      table[i] = reversed;
+   }
+   return table;
+}();
+
+
+/****************************** Function Definitions ***********************************/
+/**
+ * @brief decode a boarding pass into its seat id (row * 8 + column) one character at a time
+ * @details the pass is just a 10 bit binary number, most significant bit first. 'B' and 'R' (the upper halves)
+ *          have bit 2 clear while 'F' and 'L' have it set, so each bit is the inverse of bit 2 of its character
+ * @param pass pointer to the 10 characters of the pass
+ * @return the seat id
+*/
+constexpr uint16_t decode_pass_scalar(const char* pass)
+{
+   uint16_t id{0};
+   for (std::size_t i = 0; i < pass_length; i++)
+   {
+      id = static_cast<uint16_t>((id << 1) | ((~static_cast<unsigned>(pass[i]) >> 2) & 1));
+   }
+   return id;
+}
+
+/**
+ * @brief decode a boarding pass into its seat id using a vector compare
+ * @details bit 2 of every character is shifted up to the sign bit and gathered with a single movemask, which gives
+ *          the pass bits least significant first. Inverting them and reversing the 10 bits with a table gives the id.
+ * @param pass pointer to the 10 characters of the pass. 16 bytes must be readable from here
+ * @return the seat id
+*/
+inline uint16_t decode_pass_vector(const char* pass)
+{
+#if defined(BOARDING_PASS_SSE2)
+   const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pass));
+   const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_slli_epi16(block, 5)));
+   return reversed_bits[~mask & (seat_count - 1)];
+#else
+   return decode_pass_scalar(pass);
+#endif
+}
+
+/**
+ * @brief decode every boarding pass in a buffer
+ * @param buffer the raw input, one pass per line
+ * @param ids vector to append the seat ids to. Reused between calls to avoid allocating
+ * @note lines shorter than a pass are skipped
+*/
+inline void decode_passes(std::string_view buffer, std::vector<uint16_t>& ids)
+{
+   ids.reserve(ids.size() + buffer.size() / (pass_length + 1) + 1);
+   const char* const end = buffer.data() + buffer.size();
+   const char* position = buffer.data();
+   while (position < end)
+   {
+      auto newline = static_cast<const char*>(std::memchr(position, '\n', static_cast<std::size_t>(end - position)));
+      const char* line_end = (newline != nullptr) ? newline : end;
+      if (static_cast<std::size_t>(line_end - position) >= pass_length)
+      {
+         /* the vector load reads past the pass, so the last few passes in the buffer are decoded the slow way */
+         ids.push_back((end - position >= 16) ? decode_pass_vector(position) : decode_pass_scalar(position));
+      }
+      position = (newline != nullptr) ? newline + 1 : end;
+   }
+}
@@ -1,19 +1,18 @@
-/*! \file day_3.cpp
+/*! \file day_5.cpp
 *
-*  \brief day-3 advent of code problem
+*  \brief day-5 advent of code problem
 *
 *  \author Graham Riches
 */
 
 /********************************** Includes *******************************************/
-#include <algorithm>
-#include <fstream>
+#include <cstdint>
 #include <iostream>
-#include <numeric>
-#include <ostream>
-#include <regex>
 #include <string>
 #include <vector>
+#include "boarding_pass.h"
+#include "bounded_integers.h"
+#include "string_utilities.h"
 
 /*********************************** Consts ********************************************/
 
@@ -27,7 +26,6 @@
 /******************************** Local Variables **************************************/
 
 /****************************** Functions Prototype **************************************/
-int binary_search( std::vector<int> &input );
 
 /****************************** Functions Definition ***********************************/
 /**
@@ -38,51 +36,24 @@ int binary_search( std::vector<int> &input );
 */
 int main( int argc, char *argv[] )
 {
-   std::ifstream seat_data{ std::string{ argv[1] } };
-   std::string line;
-   std::vector<int> seats;
-   while ( std::getline( seat_data, line ) )
-   {
-      std::vector<int> binary_data(line.length());
-      std::transform( cbegin(line), cend(line), binary_data.begin(), [](const char c){ return ( (c == 'F') || (c == 'L')); } );
+   MappedFile seat_data = open_file( std::string{ argv[1] } );
 
-      std::vector<int> row_data{ binary_data.begin(), binary_data.begin() + 7 };
-      std::vector<int> col_data{ binary_data.begin() + 7, binary_data.end() };
-      auto row = binary_search(row_data);
-      auto col = binary_search(col_data);
-      seats.push_back( row*8 + col );
+   /* decode every pass in one go and mark the seats off on the map */
+   std::vector<uint16_t> seats;
+   decode_passes( seat_data.view(), seats );
+   DenseBitset seat_map{ seat_count };
+   for ( auto seat : seats )
+   {
+      seat_map.set( seat );
    }
 
    /* calculate the seat id */
-   auto max_id = std::max_element( cbegin(seats), cend(seats) );
-   std::cout << "max seat id " << *max_id << std::endl;
+   std::cout << "max seat id " << seat_map.last().value_or( 0 ) << std::endl;
 
-   /* sort, then use adjacent difference */
-   std::sort(seats.begin(), seats.end());
-   std::vector<int> diffs;
-   auto seat_bounds = std::adjacent_difference(cbegin(seats), cend(seats), std::back_inserter(diffs) );
-   auto index = std::find(begin(diffs), end(diffs), 2) - diffs.begin();
-   std::cout << "seat ID is " << seats[index] - 1;
+   /* find the gap in the occupied seats */
+   auto gaps = seat_map.isolated_gaps();
+   std::cout << "seat ID is " << ( gaps.empty() ? 0 : gaps.front() ) << std::endl;
 
    return 0;
 }
 
-
-/**
- * @brief performs a binary lower bound search on a data collection and outputs the final value
- * @param input 
- * @return 
-*/
-int binary_search(std::vector<int>& input)
-{
-   int range = 0x01 << input.size();
-   std::transform(begin(input), end(input), begin(input),
-      [range, iter = 1, accumulate = 0](bool lower_bound) mutable
-      {
-         int value = ( lower_bound ) ? accumulate : (range / (0x01 << iter)) + accumulate;
-         accumulate = value;
-         iter++;
-         return value;
-      });
-   return input.back();
-}
\ No newline at end of file
@@ -0,0 +1,289 @@
+/*! \file bag_graph.h
+*
+*  \brief bag rules stored as a graph of interned colour ids with compressed sparse row adjacency
+*
+*  \author Graham Riches
+*/
+
+#pragma once
+
+/********************************** Includes *******************************************/
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/************************************ Types ********************************************/
+/**
+ * @brief maps each colour name to a dense integer id, handed out in the order the names are first seen
+*/
+class ColorTable
+{
+public:
+   ColorTable() {};
+
+   /**
+    * @brief get the id for a colour, adding it if it hasn't been seen before
+    * @param name the colour name
+    * @return the id
+   */
+   uint32_t intern(std::string_view name)
+   {
+      auto existing = this->ids.find(name);
+      if (existing != this->ids.end())
+      {
+         return existing->second;
+      }
+      const auto id = static_cast<uint32_t>(this->names.size());
+      this->names.emplace_back(name);
+      this->ids.emplace(this->names.back(), id);
+      return id;
+   }
+
+   /**
+    * @brief look up the id for a colour without adding it
+    * @param name the colour name
+    * @return the id, or nullopt if the colour isn't in the table
+   */
+   std::optional<uint32_t> find(std::string_view name) const
+   {
+      auto existing = this->ids.find(name);
+      return (existing != this->ids.end()) ? std::optional<uint32_t>{ existing->second } : std::nullopt;
+   }
+
+   std::string_view name(uint32_t id) const
+   {
+      return this->names[id];
+   }
+
+   std::size_t size(void) const
+   {
+      return this->names.size();
+   }
+
+private:
+   std::deque<std::string> names;                          //!< deque so the keys below never move
+   std::unordered_map<std::string_view, uint32_t> ids;
+};
+
+
+/**
+ * @brief the bag rules as a directed graph from each bag to the bags it must contain
+ * @details edges are kept in compressed sparse row form: the edges out of bag i are entries
+ *          [offsets[i], offsets[i + 1]) of flat target and count arrays. The reverse graph (bag to the
+ *          bags that directly contain it) is stored the same way so both directions are a contiguous scan.
+*/
+class BagGraph
+{
+public:
+   BagGraph() {};
+
+   /**
+    * @brief build the graph from rule lines like "light red bags contain 1 bright white bag, 2 muted yellow bags."
+    * @tparam Range range of string_views (i.e. MappedFile::lines())
+    * @param lines the rules
+    * @return the new graph
+    * @note lines that aren't rules are skipped
+   */
+   template <typename Range>
+   static BagGraph from_lines(Range&& lines)
+   {
+      BagGraph graph;
+      std::vector<uint32_t> sources;
+      std::vector<uint32_t> targets;
+      std::vector<uint32_t> counts;
+      for (std::string_view line : lines)
+      {
+         graph.parse_rule(line, sources, targets, counts);
+      }
+      graph.build(sources, targets, counts);
+      return graph;
+   }
+
+   /**
+    * @brief get the number of colours in the graph
+    * @return colour count
+   */
+   std::size_t size(void) const
+   {
+      return this->colors.size();
+   }
+
+   const ColorTable& color_table(void) const
+   {
+      return this->colors;
+   }
+
+   /**
+    * @brief get the bags a bag must directly contain
+    * @param bag the bag id
+    * @return the contained bag ids
+   */
+   std::span<const uint32_t> children(uint32_t bag) const
+   {
+      return { this->forward_targets.data() + this->forward_offsets[bag], this->forward_offsets[bag + 1] - this->forward_offsets[bag] };
+   }
+
+   /**
+    * @brief get how many of each child a bag must contain, in the same order as children()
+    * @param bag the bag id
+    * @return the counts
+   */
+   std::span<const uint32_t> child_counts(uint32_t bag) const
+   {
+      return { this->forward_counts.data() + this->forward_offsets[bag], this->forward_offsets[bag + 1] - this->forward_offsets[bag] };
+   }
+
+   /**
+    * @brief get the bags that directly contain a bag
+    * @param bag the bag id
+    * @return the containing bag ids
+   */
+   std::span<const uint32_t> parents(uint32_t bag) const
+   {
+      return { this->reverse_sources.data() + this->reverse_offsets[bag], this->reverse_offsets[bag + 1] - this->reverse_offsets[bag] };
+   }
+
+private:
+   ColorTable colors;
+   std::vector<std::size_t> forward_offsets;
+   std::vector<uint32_t> forward_targets;
+   std::vector<uint32_t> forward_counts;
+   std::vector<std::size_t> reverse_offsets;
+   std::vector<uint32_t> reverse_sources;
+
+   /**
+    * @brief parse a single rule into a list of edges
+    * @param line the rule
+    * @param sources edge source ids
+    * @param targets edge target ids
+    * @param counts edge counts
+   */
+   void parse_rule(std::string_view line, std::vector<uint32_t>& sources, std::vector<uint32_t>& targets, std::vector<uint32_t>& counts)
+   {
+      static constexpr std::string_view contain{ " bags contain " };
+      const auto split = line.find(contain);
+      if (split == std::string_view::npos)
+      {
+         return;
+      }
+      const uint32_t parent = this->colors.intern(line.substr(0, split));
+
+      /* each entry is "N adjective colour bag(s)" separated by ", ". "no other bags." fails the number parse */
+      std::string_view rest = line.substr(split + contain.size());
+      while (!rest.empty())
+      {
+         uint32_t count{0};
+         auto [after_count, error] = std::from_chars(rest.data(), rest.data() + rest.size(), count);
+         if ((error != std::errc{}) || (after_count == rest.data() + rest.size()))
+         {
+            return;
+         }
+         rest.remove_prefix(static_cast<std::size_t>(after_count - rest.data()) + 1);
+         const auto name_end = rest.find(" bag");
+         if (name_end == std::string_view::npos)
+         {
+            return;
+         }
+         sources.push_back(parent);
+         targets.push_back(this->colors.intern(rest.substr(0, name_end)));
+         counts.push_back(count);
+
+         const auto next = rest.find(", ", name_end);
+         rest = (next != std::string_view::npos) ? rest.substr(next + 2) : std::string_view{};
+      }
+   }
+
+   /**
+    * @brief build both adjacency arrays from the edge lists with a counting pass and a scatter pass
+    * @param sources edge source ids
+    * @param targets edge target ids
+    * @param counts edge counts
+   */
+   void build(const std::vector<uint32_t>& sources, const std::vector<uint32_t>& targets, const std::vector<uint32_t>& counts)
+   {
+      const std::size_t node_count = this->colors.size();
+      const std::size_t edge_count = sources.size();
+      this->forward_offsets.assign(node_count + 1, 0);
+      this->reverse_offsets.assign(node_count + 1, 0);
+      for (std::size_t edge = 0; edge < edge_count; edge++)
+      {
+         this->forward_offsets[sources[edge] + 1]++;
+         this->reverse_offsets[targets[edge] + 1]++;
+      }
+      for (std::size_t node = 0; node < node_count; node++)
+      {
+         this->forward_offsets[node + 1] += this->forward_offsets[node];
+         this->reverse_offsets[node + 1] += this->reverse_offsets[node];
+      }
+
+      this->forward_targets.resize(edge_count);
+      this->forward_counts.resize(edge_count);
+      this->reverse_sources.resize(edge_count);
+      std::vector<std::size_t> forward_next(this->forward_offsets.begin(), this->forward_offsets.end() - 1);
+      std::vector<std::size_t> reverse_next(this->reverse_offsets.begin(), this->reverse_offsets.end() - 1);
+      for (std::size_t edge = 0; edge < edge_count; edge++)
+      {
+         const auto forward_slot = forward_next[sources[edge]]++;
+         this->forward_targets[forward_slot] = targets[edge];
+         this->forward_counts[forward_slot] = counts[edge];
+         this->reverse_sources[reverse_next[targets[edge]]++] = sources[edge];
+      }
+   }
+};
+
+
+/****************************** Function Definitions ***********************************/
+/**
+ * @brief count the bags inside every bag in the graph
+ * @details bags are finished leaves first: a bag's total is worked out once, as soon as the last of its children is
+ *          done, and its parents are then told about it through the reverse adjacency. Every bag and edge is visited
+ *          once with no recursion, so the totals for all bags cost O(bags + rules).
+ * @param graph the bag graph
+ * @return the number of bags inside each bag, indexed by id. Bags caught in a containment cycle are left at zero
+*/
+inline std::vector<uint64_t> count_contained_bags(const BagGraph& graph)
+{
+   const std::size_t node_count = graph.size();
+   std::vector<uint64_t> totals(node_count, 0);
+   std::vector<std::size_t> remaining(node_count);
+   std::vector<uint32_t> ready;
+   for (uint32_t bag = 0; bag < node_count; bag++)
+   {
+      remaining[bag] = graph.children(bag).size();
+      if (remaining[bag] == 0)
+      {
+         ready.push_back(bag);
+      }
+   }
+
+   while (!ready.empty())
+   {
+      const uint32_t bag = ready.back();
+      ready.pop_back();
+
+      auto children = graph.children(bag);
+      auto counts = graph.child_counts(bag);
+      uint64_t total{0};
+      for (std::size_t i = 0; i < children.size(); i++)
+      {
+         total += counts[i] * (1 + totals[children[i]]);
+      }
+      totals[bag] = total;
+
+      for (auto parent : graph.parents(bag))
+      {
+         if (--remaining[parent] == 0)
+         {
+            ready.push_back(parent);
+         }
+      }
+   }
+   return totals;
+}
@@ -0,0 +1,163 @@
+/*! \file container_query.h
+*
+*  \brief reverse reachability queries over the bag graph: which bags can eventually hold a given bag
+*
+*  \author Graham Riches
+*/
+
+#pragma once
+
+/********************************** Includes *******************************************/
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "bag_graph.h"
+#include "bounded_integers.h"
+
+/************************************ Types ********************************************/
+/**
+ * @brief answers "which bags can eventually contain X" by walking the parent lists of the bag graph
+ * @details a single query is a breadth first search up the reverse adjacency with a dense visited bitset. Batched
+ *          queries run 64 at a time: every bag carries a 64 bit mask of the queries that reach it and masks are
+ *          pushed up to the parents until nothing changes, so one walk of the graph answers all 64 queries.
+*/
+class ContainerQuery
+{
+public:
+   /**
+    * @brief create a query engine for a graph
+    * @param graph the graph. Must outlive the engine
+   */
+   explicit ContainerQuery(const BagGraph& graph)
+      : graph(graph)
+   {}
+
+   /**
+    * @brief find every bag that can eventually contain a bag
+    * @param bag the bag id
+    * @return set of the containing bag ids. The bag itself is only included if it can contain itself
+   */
+   DenseBitset containers_of(uint32_t bag) const
+   {
+      DenseBitset visited{ this->graph.size() };
+      std::vector<uint32_t> frontier{ bag };
+      std::vector<uint32_t> next;
+      while (!frontier.empty())
+      {
+         for (auto node : frontier)
+         {
+            for (auto parent : this->graph.parents(node))
+            {
+               if (!visited.test(parent))
+               {
+                  visited.set(parent);
+                  next.push_back(parent);
+               }
+            }
+         }
+         std::swap(frontier, next);
+         next.clear();
+      }
+      return visited;
+   }
+
+   /**
+    * @brief find every bag that can eventually contain each of a list of bags
+    * @param bags the bag ids to query
+    * @return set of the containing bag ids for each query, in the same order. Each set matches containers_of(bag)
+   */
+   std::vector<DenseBitset> containers_of(std::span<const uint32_t> bags) const
+   {
+      std::vector<DenseBitset> containers(bags.size(), DenseBitset{ this->graph.size() });
+      for (std::size_t first = 0; first < bags.size(); first += batch_size)
+      {
+         const auto batch = bags.subspan(first, std::min(batch_size, bags.size() - first));
+         const auto reached = this->reach_batch(batch);
+         for (uint32_t bag = 0; bag < reached.size(); bag++)
+         {
+            for (uint64_t mask = reached[bag]; mask != 0; mask &= mask - 1)
+            {
+               containers[first + static_cast<std::size_t>(std::countr_zero(mask))].set(bag);
+            }
+         }
+      }
+      return containers;
+   }
+
+   /**
+    * @brief count the bags that can eventually contain each of a list of bags
+    * @param bags the bag ids to query
+    * @return the number of containing bags for each query, in the same order
+   */
+   std::vector<std::size_t> count_containers(std::span<const uint32_t> bags) const
+   {
+      std::vector<std::size_t> counts(bags.size(), 0);
+      for (std::size_t first = 0; first < bags.size(); first += batch_size)
+      {
+         const auto batch = bags.subspan(first, std::min(batch_size, bags.size() - first));
+         const auto reached = this->reach_batch(batch);
+         for (auto mask : reached)
+         {
+            for (; mask != 0; mask &= mask - 1)
+            {
+               counts[first + static_cast<std::size_t>(std::countr_zero(mask))]++;
+            }
+         }
+      }
+      return counts;
+   }
+
+private:
+   static constexpr std::size_t batch_size = 64;
+   const BagGraph& graph;
+
+   /**
+    * @brief propagate up to 64 queries up the graph at once
+    * @param bags the queried bags. Query i owns bit i
+    * @return mask per bag id of the queries that bag can contain
+   */
+   std::vector<uint64_t> reach_batch(std::span<const uint32_t> bags) const
+   {
+      std::vector<uint64_t> reached(this->graph.size(), 0);
+      DenseBitset queued{ this->graph.size() };
+      std::vector<uint32_t> worklist;
+
+      auto push = [&](uint32_t node, uint64_t mask)
+      {
+         if ((mask & ~reached[node]) == 0)
+         {
+            return;
+         }
+         reached[node] |= mask;
+         if (!queued.test(node))
+         {
+            queued.set(node);
+            worklist.push_back(node);
+         }
+      };
+
+      /* seed each query's direct parents so a bag only counts itself if it really can contain itself */
+      for (std::size_t query = 0; query < bags.size(); query++)
+      {
+         for (auto parent : this->graph.parents(bags[query]))
+         {
+            push(parent, uint64_t{ 1 } << query);
+         }
+      }
+
+      while (!worklist.empty())
+      {
+         const uint32_t node = worklist.back();
+         worklist.pop_back();
+         queued.reset(node);
+         for (auto parent : this->graph.parents(node))
+         {
+            push(parent, reached[node]);
+         }
+      }
+      return reached;
+   }
+};
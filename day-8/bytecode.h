@@ -0,0 +1,361 @@
+/*! \file bytecode.h
+*
+*  \brief compact encoding of the boot code and a threaded interpreter to run it
+*
+*  \author Graham Riches
+*/
+
+#pragma once
+
+/********************************** Includes *******************************************/
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+/************************************ Types ********************************************/
+/**
+ * @brief enumeration of instructions. The values are the encoded opcodes
+*/
+enum class Instructions : uint32_t
+{
+   nop = 0,
+   acc,
+   jmp
+};
+
+
+/**
+ * @brief enumeration of possible emulation loop states
+*/
+enum class RunStatus : unsigned
+{
+   infinite_loop,
+   terminated,
+   out_of_bounds,     //!< jumped somewhere other than an instruction or one past the last instruction
+   step_limit         //!< ran out of steps. Resume by running again from last with the same accumulator and visited bits
+};
+
+
+/**
+ * @brief result of running a program
+*/
+struct RunResult
+{
+   RunStatus status{RunStatus::infinite_loop};
+   int64_t accumulator{0};
+   uint64_t steps{0};         //!< number of instructions executed
+   int64_t last{0};           //!< program counter the run stopped at
+};
+
+
+/**
+ * @brief a program as one 32 bit word per instruction: the opcode in the low two bits and the signed operand in
+ *        the upper 30 bits. The whole program is a flat array of plain integers so it is cheap to copy and to scan
+*/
+struct Program
+{
+   std::vector<uint32_t> code;
+
+   static constexpr uint32_t opcode_bits = 2;
+   static constexpr uint32_t opcode_mask = (1u << opcode_bits) - 1;
+   static constexpr int32_t operand_max = (1 << (31 - opcode_bits)) - 1;
+   static constexpr int32_t operand_min = -operand_max - 1;
+
+   /**
+    * @brief pack an instruction into a word
+    * @param instruction the opcode
+    * @param operand the operand. Must be in [operand_min, operand_max]
+    * @return the encoded word
+   */
+   static constexpr uint32_t encode(Instructions instruction, int32_t operand)
+   {
+      return (static_cast<uint32_t>(operand) << opcode_bits) | static_cast<uint32_t>(instruction);
+   }
+
+   static constexpr Instructions opcode(uint32_t word)
+   {
+      return static_cast<Instructions>(word & opcode_mask);
+   }
+
+   static constexpr int32_t operand(uint32_t word)
+   {
+      return static_cast<int32_t>(word) >> opcode_bits;
+   }
+
+   std::size_t size(void) const
+   {
+      return this->code.size();
+   }
+
+   uint32_t operator[](std::size_t index) const
+   {
+      return this->code[index];
+   }
+
+   /**
+    * @brief parse "op +/-value" lines straight out of a buffer
+    * @details instruction indices are jump targets, so a line can't just be dropped: anything other than a blank
+    *          line that isn't a well formed instruction fails the whole parse
+    * @param buffer the raw input, one instruction per line
+    * @param error_line if not null, set to the (1 based) line number of the first line that couldn't be parsed
+    * @return the program, or nullopt if a line is malformed or its operand doesn't fit in the encoding
+    * @note blank lines (including whitespace only lines) are skipped
+   */
+   static std::optional<Program> parse(std::string_view buffer, std::size_t* error_line = nullptr)
+   {
+      Program program;
+      program.code.reserve(buffer.size() / 7 + 1);
+      const char* const end = buffer.data() + buffer.size();
+      const char* position = buffer.data();
+      for (std::size_t line = 1; position < end; line++)
+      {
+         auto newline = static_cast<const char*>(std::memchr(position, '\n', static_cast<std::size_t>(end - position)));
+         const char* line_end = (newline != nullptr) ? newline : end;
+         if (!program.parse_instruction(std::string_view{ position, static_cast<std::size_t>(line_end - position) }))
+         {
+            if (error_line != nullptr)
+            {
+               *error_line = line;
+            }
+            return std::nullopt;
+         }
+         position = (newline != nullptr) ? newline + 1 : end;
+      }
+      return program;
+   }
+
+private:
+   /**
+    * @brief parse one line and append it
+    * @param line the line
+    * @return true if the line was an instruction or blank, false if it is malformed or the operand is outside
+    *         [operand_min, operand_max]
+   */
+   bool parse_instruction(std::string_view line)
+   {
+      while (!line.empty() && ((line.back() == '\r') || (line.back() == ' ') || (line.back() == '\t')))
+      {
+         line.remove_suffix(1);
+      }
+      if (line.find_first_not_of(" \t") == std::string_view::npos)
+      {
+         return true;
+      }
+      if ((line.size() < 6) || (line[3] != ' '))
+      {
+         return false;
+      }
+
+      Instructions instruction{Instructions::nop};
+      const auto name = line.substr(0, 3);
+      if (name == "acc")
+      {
+         instruction = Instructions::acc;
+      }
+      else if (name == "jmp")
+      {
+         instruction = Instructions::jmp;
+      }
+      else if (name != "nop")
+      {
+         return false;
+      }
+
+      /* from_chars doesn't take a leading '+'. Parse wide so anything too big for the encoding is caught */
+      const char* number = line.data() + 4 + (line[4] == '+');
+      const char* const line_end = line.data() + line.size();
+      if ((number == line_end) || ((*number != '-') && ((*number < '0') || (*number > '9'))) || ((line[4] == '+') && (*number == '-')))
+      {
+         return false;
+      }
+      int64_t operand{0};
+      auto [number_end, error] = std::from_chars(number, line_end, operand);
+      if ((error != std::errc{}) || (number_end != line_end) || (operand < operand_min) || (operand > operand_max))
+      {
+         return false;
+      }
+      this->code.push_back(encode(instruction, static_cast<int32_t>(operand)));
+      return true;
+   }
+};
+
+
+/**
+ * @brief tracer policy that does nothing. Every hook in the interpreter is behind an if constexpr on enabled, so
+ *        running with this tracer compiles to exactly the same loop as having no hooks at all
+*/
+struct NullTracer
+{
+   static constexpr bool enabled = false;
+
+   void on_start(std::size_t, int64_t) {}
+   void on_execute(int64_t, uint32_t, int64_t) {}
+   void on_jump(int64_t, int32_t) {}
+   void on_finish(const RunResult&) {}
+};
+
+
+/****************************** Function Definitions ***********************************/
+/**
+ * @brief run a program until it terminates, jumps out of bounds, or is about to execute an instruction a second time
+ * @details the visited flags are kept as a separate bit array rather than in the program so the same program can be
+ *          run over and over (or shared between threads) without copying it. With GCC/Clang the loop is threaded
+ *          code: every handler ends in its own indirect jump through a table of label addresses, which gives the
+ *          branch predictor one jump per opcode to learn instead of a single shared switch. Other compilers fall back
+ *          to the switch.
+ * @tparam Tracer instrumentation policy (see NullTracer for the hooks)
+ * @tparam Code anything with size() and an operator[] returning encoded words, i.e. Program or a patched overlay of one
+ * @param program the program
+ * @param visited one bit per instruction, sized to at least (program.size() + 63) / 64 words and cleared by the caller
+ * @param tracer the tracer to report to
+ * @param start the instruction to start at
+ * @param accumulator the starting accumulator
+ * @param max_steps stop with RunStatus::step_limit after this many instructions, so long runs can be checked on
+ * @return the result of the run
+*/
+template <typename Tracer, typename Code>
+RunResult execute(const Code& program, std::vector<uint64_t>& visited, Tracer& tracer, int64_t start = 0, int64_t accumulator = 0,
+                  uint64_t max_steps = std::numeric_limits<uint64_t>::max())
+{
+   const uint64_t size = program.size();
+   uint64_t* const seen = visited.data();
+   int64_t pc = start;
+   uint64_t steps = 0;
+   uint32_t word = 0;
+   RunResult result;
+   if constexpr (Tracer::enabled)
+   {
+      tracer.on_start(program.size(), start);
+   }
+
+   /* shared preamble of every dispatch: bounds check, loop check, step budget, mark visited and fetch */
+#define BYTECODE_FETCH()                                                             \
+   if (static_cast<uint64_t>(pc) >= size)                                            \
+   {                                                                                 \
+      result.status = (static_cast<uint64_t>(pc) == size) ? RunStatus::terminated     \
+                                                          : RunStatus::out_of_bounds; \
+      goto finished;                                                                 \
+   }                                                                                 \
+   if ((seen[static_cast<uint64_t>(pc) >> 6] >> (pc & 63)) & 1)                      \
+   {                                                                                 \
+      result.status = RunStatus::infinite_loop;                                      \
+      goto finished;                                                                 \
+   }                                                                                 \
+   if (steps == max_steps)                                                           \
+   {                                                                                 \
+      result.status = RunStatus::step_limit;                                         \
+      goto finished;                                                                 \
+   }                                                                                 \
+   seen[static_cast<uint64_t>(pc) >> 6] |= uint64_t{1} << (pc & 63);                 \
+   word = program[static_cast<std::size_t>(pc)];                                     \
+   steps++;                                                                          \
+   if constexpr (Tracer::enabled)                                                    \
+   {                                                                                 \
+      tracer.on_execute(pc, word, accumulator);                                      \
+   }
+
+#if defined(__GNUC__)
+   static void* const handlers[] = { &&op_nop, &&op_acc, &&op_jmp, &&op_nop };
+#define BYTECODE_DISPATCH()                                                          \
+   BYTECODE_FETCH()                                                                  \
+   goto *handlers[word & Program::opcode_mask];
+
+   BYTECODE_DISPATCH();
+
+op_nop:
+   pc++;
+   BYTECODE_DISPATCH();
+
+op_acc:
+   accumulator += Program::operand(word);
+   pc++;
+   BYTECODE_DISPATCH();
+
+op_jmp:
+   if constexpr (Tracer::enabled)
+   {
+      tracer.on_jump(pc, Program::operand(word));
+   }
+   pc += Program::operand(word);
+   BYTECODE_DISPATCH();
+
+#undef BYTECODE_DISPATCH
+#else
+   while (true)
+   {
+      BYTECODE_FETCH()
+      switch (Program::opcode(word))
+      {
+         case Instructions::acc:
+            accumulator += Program::operand(word);
+            pc++;
+            break;
+
+         case Instructions::jmp:
+            if constexpr (Tracer::enabled)
+            {
+               tracer.on_jump(pc, Program::operand(word));
+            }
+            pc += Program::operand(word);
+            break;
+
+         default:
+            pc++;
+            break;
+      }
+   }
+#endif
+#undef BYTECODE_FETCH
+
+finished:
+   result.accumulator = accumulator;
+   result.steps = steps;
+   result.last = pc;
+   if constexpr (Tracer::enabled)
+   {
+      tracer.on_finish(result);
+   }
+   return result;
+}
+
+/**
+ * @brief run a program with no instrumentation
+ * @param program the program
+ * @param visited one bit per instruction, cleared by the caller
+ * @param start the instruction to start at
+ * @param accumulator the starting accumulator
+ * @return the result of the run
+*/
+inline RunResult execute(const Program& program, std::vector<uint64_t>& visited, int64_t start = 0, int64_t accumulator = 0)
+{
+   NullTracer tracer;
+   return execute(program, visited, tracer, start, accumulator);
+}
+
+/**
+ * @brief clear the visited bits set by a run by following its path again
+ * @details control flow doesn't depend on the accumulator, so the path a run took is fixed by its start and step
+ *          count. Retracing it costs O(steps) rather than O(program size) for clearing the whole bit array, which
+ *          matters when many short runs share one visited array.
+ * @tparam Code Program or a patched overlay of one. Must be the same code the run executed
+ * @param program the program
+ * @param visited the visited bits the run used
+ * @param start the instruction the run started at
+ * @param steps number of instructions the run executed
+*/
+template <typename Code>
+void clear_visited(const Code& program, std::vector<uint64_t>& visited, int64_t start, uint64_t steps)
+{
+   int64_t pc = start;
+   for (uint64_t step = 0; step < steps; step++)
+   {
+      visited[static_cast<uint64_t>(pc) >> 6] &= ~(uint64_t{1} << (pc & 63));
+      const uint32_t word = program[static_cast<std::size_t>(pc)];
+      pc += (Program::opcode(word) == Instructions::jmp) ? Program::operand(word) : 1;
+   }
+}
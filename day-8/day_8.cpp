@@ -7,16 +7,21 @@
 
 /********************************** Includes *******************************************/
 #include <algorithm>
-#include <fstream>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <optional>
 #include <iostream>
 #include <numeric>
-#include <ostream>
-#include <regex>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
-#include <functional>
-#include <set>
-#include <map>
+#include "bytecode.h"
+#include "repair.h"
+#include "speculative.h"
+#include "tracer.h"
+#include "string_utilities.h"
 
 
 /*********************************** Consts ********************************************/
@@ -32,203 +37,202 @@
 
 /****************************** Functions Prototype **************************************/
 /**
- * @brief enumeration of instructions
+ * @brief emulator for the handheld boot code
+ * @tparam Tracer instrumentation policy. The default NullTracer compiles every hook out of the interpreter
 */
-enum class Instructions : unsigned
-{
-   nop = 0,
-   acc,
-   jmp
-};
-
-
-/**
- * @brief enumeration of possible emulation loop states
-*/
-enum class RunStatus : unsigned
-{
-   infinite_loop,
-   terminated
-};
-
-
-/**
- * @brief map from string to instruction type
-*/
-static const std::map<std::string, Instructions> instruction_map{ {"nop", Instructions::nop}, {"acc", Instructions::acc}, {"jmp", Instructions::jmp} };
-
-
-/**
- * @brief struct to store instructions
-*/
-struct Instruction
-{
-   Instructions instruction{Instructions::nop};
-   int value{0};
-   bool executed{false};
-   Instruction( Instructions instruction, int value ) : instruction(instruction), value(value) {};
-};
-
-
-/**
- * @brief function to split a string based on a delimiter
- * @param input the string to split
- * @param substring substring to split by
- * @return 
-*/
-inline static std::vector<std::string> split(std::string &input, const std::string& substring)
-{
-   std::vector<std::string> list;
-   size_t substring_pos{std::string::npos};
-   while ((substring_pos = input.find(substring)) != std::string::npos)
-   {
-      list.push_back(input.substr(0, substring_pos));
-      input.erase(0, substring_pos + substring.length());
-   }
-   list.push_back(input.substr(0, input.length()));
-   return list;
-}
-
-
+template <typename Tracer = NullTracer>
 class Emulator
 {
    public:
-      int accumulator{0};
-      std::vector<Instruction> instructions;
-   
-      Emulator(const std::string& instruction_file)
-      {
-         this->load_instructions( instruction_file );
-      }
+      int64_t accumulator{0};
+      uint64_t steps{0};
+      Program program;
+      Tracer tracer;
 
-      Emulator(std::vector<Instruction>& instructions_list) : instructions(instructions_list) 
-      {
-         for (auto& instruction : this->instructions)
-         {
-            instruction.executed = false;
-         }
-      };            
+      Emulator() {};
+
+      Emulator(const Program& program) : program(program) {};
 
       /**
-       * @brief 
-       * @param instruction_file 
+       * @brief load and encode the instructions from a file
+       * @param instruction_file path to the file
+       * @return false if a line is malformed or can't be encoded. The error is reported on stderr and the program is left as it was
       */
-      void load_instructions(const std::string& instruction_file)
+      bool load_instructions(const std::string& instruction_file)
       {
-         std::ifstream stream{ instruction_file };
-         std::string line;
-         while (std::getline(stream, line))
+         MappedFile file = open_file( instruction_file );
+         std::size_t error_line{0};
+         auto parsed = Program::parse( file.view(), &error_line );
+         if ( !parsed.has_value() )
          {
-            auto strings = split(line, " ");
-            Instruction instruction{instruction_map.at(strings[0]), std::stoi(strings[1]) };
-            this->instructions.push_back(instruction);
+            std::cerr << instruction_file << ":" << error_line << ": not an instruction, or the operand is outside ["
+                      << Program::operand_min << ", " << Program::operand_max << "]" << std::endl;
+            return false;
          }
+         this->program = std::move( *parsed );
+         return true;
       }
 
       /**
-       * @brief run the current instruction and return the next instruction
-       * @param current_instruction 
-       * @return 
+       * @brief run the emulation terminating either after detecting an infinite loop or proper termination
+       * @return how the run ended
       */
-      int run_instruction(int current_instruction)
+      RunStatus run(void)
       {
-         auto instruction = this->instructions[current_instruction];
-         int next_instruction{0};
-         switch (instruction.instruction)
-         {
-            case Instructions::acc:
-               this->accumulator += instruction.value;
-               next_instruction = current_instruction + 1;
-               break;
-
-            case Instructions::jmp:
-               next_instruction = current_instruction + instruction.value;
-               break;
-
-            case Instructions::nop:
-               next_instruction = current_instruction + 1;
-               break;
-
-            default:
-               break;
-         }
-         this->instructions[current_instruction].executed = true;
-         return next_instruction;
+         this->visited.assign( (this->program.size() + 63) / 64, 0 );
+         RunResult result = execute( this->program, this->visited, this->tracer );
+         this->accumulator = result.accumulator;
+         this->steps = result.steps;
+         return result.status;
       }
 
       /**
-       * @brief run the emulation terminating either after detecting an infinite loop or proper termination
+       * @brief speculative mode: run many patched copies of the program on a thread pool and keep the first that terminates
+       * @param candidates the patch sets to try
+       * @param pool the pool to run on
+       * @return the winning candidate, or nullopt if none terminate
       */
-      RunStatus run(void)
-      {         
-         int current_instruction{0};
-         RunStatus status{RunStatus::infinite_loop};
-
-         while ( this->instructions[current_instruction].executed == false )
-         {                                   
-            int next_instruction = this->run_instruction(current_instruction);
-
-            /* check for successful termination */
-            if ( next_instruction == this->instructions.size() )
-            {
-               status = RunStatus::terminated;
-               break;
-            }
-
-            current_instruction = next_instruction;            
+      std::optional<SpeculativeResult> run_speculative(const std::vector<std::vector<Patch>>& candidates, ThreadPool& pool)
+      {
+         auto result = ::run_speculative( this->program, candidates, pool );
+         if ( result.has_value() )
+         {
+            this->accumulator = result->run.accumulator;
+            this->steps = result->run.steps;
          }
-         return status;
+         return result;
       }
+
+   private:
+      std::vector<uint64_t> visited;      //!< one bit per instruction, kept out of the program so it never needs copying
 };
 
 
+/**
+ * @brief run the program repeatedly and report the interpreter throughput
+ * @param emulator the emulator to run
+ * @param runs number of runs
+*/
+template <typename Tracer>
+void run_benchmark(Emulator<Tracer>& emulator, int runs)
+{
+   uint64_t total_steps{0};
+   auto start = std::chrono::steady_clock::now();
+   for (int run = 0; run < runs; run++)
+   {
+      emulator.run();
+      total_steps += emulator.steps;
+   }
+   std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+   std::cout << "benchmark: " << runs << " runs, " << total_steps << " instructions in " << elapsed.count() << " s ("
+             << ( (elapsed.count() > 0) ? static_cast<double>(total_steps) / elapsed.count() : 0.0 ) << " instructions/s)" << std::endl;
+}
+
+
+/**
+ * @brief run the program once with the profiling tracer and report the hot spots
+ * @param program the program
+ * @param trace_file file to dump the binary trace to
+*/
+void run_profile(const Program& program, const std::string& trace_file)
+{
+   Emulator<ProfilingTracer> profiled{program};
+   RunStatus status = profiled.run();
+   const auto& tracer = profiled.tracer;
+
+   /* hottest instructions first */
+   std::vector<std::size_t> order(tracer.execution_counts.size());
+   std::iota(order.begin(), order.end(), 0);
+   auto shown = std::min<std::size_t>(order.size(), 5);
+   std::partial_sort(order.begin(), order.begin() + shown, order.end(),
+      [&tracer](std::size_t a, std::size_t b){ return tracer.execution_counts[a] > tracer.execution_counts[b]; });
+
+   std::cout << "profile: " << profiled.steps << " instructions in " << tracer.last_run_time.count() << " ns"
+             << ((status == RunStatus::infinite_loop) ? " (ended in a loop)" : "") << std::endl;
+   for (std::size_t i = 0; i < shown; i++)
+   {
+      std::cout << "   instruction " << order[i] << " ran " << tracer.execution_counts[order[i]] << " times" << std::endl;
+   }
+   for (auto [pc, count] : tracer.jump_counts)
+   {
+      std::cout << "   jmp " << Program::operand(program[pc]) << " at instruction " << pc << " taken " << count << " times" << std::endl;
+   }
+   if (tracer.dump(trace_file))
+   {
+      std::cout << "   wrote " << tracer.trace_size() << " trace entries to " << trace_file << std::endl;
+   }
+}
+
+
 /****************************** Functions Definition ***********************************/
 /**
  * @brief main application entry point
  * @param argc number of arguments
- * @param argv pointer to array of inputs
+ * @param argv pointer to array of inputs. After the input file, "--benchmark [runs]" times the interpreter and
+ *             "--speculative" also searches for the repair by running every swap on a thread pool.
+ *             "--profile [trace file]" reports the hot instructions and jumps and dumps the binary trace
  * @return integer return code
 */
 int main( int argc, char *argv[] )
 {     
 
-   Emulator game{std::string{argv[1]}};
-   auto status = game.run();
+   Emulator game;
+   if ( !game.load_instructions( std::string{argv[1]} ) )
+   {
+      return 1;
+   }
+   game.run();
    std::cout << "value in the accumulator before executing an instruction twice: " << game.accumulator << std::endl;
 
-   /* part two solution */      
-   /* create a new vector of instructions that is a clone of the existing instruction set but with all nop/jmp swapped */
-   const std::map <Instructions, Instructions> remap{ {Instructions::jmp, Instructions::nop}, 
-                                                      {Instructions::nop, Instructions::jmp}, 
-                                                      {Instructions::acc, Instructions::acc} };
-   
-   std::vector<Instruction> instructions;      
-   std::transform( game.instructions.cbegin(), game.instructions.cend(), std::back_inserter(instructions), 
-      [remap](Instruction &i)
+   /* optional modes after the input file */
+   bool speculative{false};
+   for ( int arg = 2; arg < argc; arg++ )
+   {
+      std::string option{argv[arg]};
+      if ( option == "--benchmark" )
       {
-         i.instruction = remap.at(i.instruction);
-         return i;
+         bool has_count = (arg + 1 < argc) && std::isdigit(static_cast<unsigned char>(argv[arg + 1][0]));
+         run_benchmark( game, has_count ? std::stoi(argv[++arg]) : 1000 );
       }
-   );
+      else if ( option == "--speculative" )
+      {
+         speculative = true;
+      }
+      else if ( option == "--profile" )
+      {
+         bool has_file = (arg + 1 < argc) && (std::string_view{argv[arg + 1]}.substr(0, 2) != "--");
+         run_profile( game.program, has_file ? std::string{argv[++arg]} : std::string{"trace.bin"} );
+      }
+   }
 
-   /* simulate each game iteration by swapping the instructions around inside a lambda */
-   auto run_simulation = [game, count = 0]( Instruction &i ) mutable
+   /* part two solution */      
+   /* find the instructions that already reach the exit, then swap the first nop/jmp on the path that lands in them */
+   auto repair = find_repair( game.program );
+   if ( repair.has_value() )
    {
-      std::vector<Instruction> instructions = game.instructions;
-      instructions[count] = i;
-
-      Emulator new_emulator{instructions};
-      RunStatus status = ( instructions[count].instruction == Instructions::acc ) ? RunStatus::infinite_loop : new_emulator.run();
-      count++;
-      return std::pair<RunStatus, int>{status, new_emulator.accumulator};
-   };
-
-   /* run each iteration and store the status + accumulator value in a std::pair */
-   std::vector<std::pair<RunStatus, int>> run_status;
-   std::transform( instructions.begin(), instructions.end(), std::back_inserter(run_status), run_simulation );
-
-   /* fetch the successful swap and output the value */
-   auto iterator = std::find_if(run_status.cbegin(), run_status.cend(), [](const auto &status){ return status.first == RunStatus::terminated; });   
-   std::cout << "value in accumulator on successful exit: " << iterator->second << std::endl;
+      std::cout << "patched instruction " << repair->index << " (" << ( (repair->original == Instructions::jmp) ? "jmp -> nop" : "nop -> jmp" ) << ")" << std::endl;
+      std::cout << "value in accumulator on successful exit: " << repair->accumulator << std::endl;
+   }
+   else
+   {
+      std::cout << "no single nop/jmp swap fixes the program" << std::endl;
+   }
+
+   /* cross check by trying every swap at once on a thread pool */
+   if ( speculative )
+   {
+      ThreadPool pool;
+      auto candidates = single_swap_candidates( game.program );
+      auto result = game.run_speculative( candidates, pool );
+      if ( result.has_value() )
+      {
+         std::cout << "speculative: patched instruction " << candidates[result->candidate].front().index << ", accumulator " << result->run.accumulator << std::endl;
+      }
+      else
+      {
+         std::cout << "speculative: no candidate terminated" << std::endl;
+      }
+   }
    return 0;
 }
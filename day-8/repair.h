@@ -0,0 +1,149 @@
+/*! \file repair.h
+*
+*  \brief linear time search for the single nop/jmp swap that lets the boot code terminate
+*
+*  \author Graham Riches
+*/
+
+#pragma once
+
+/********************************** Includes *******************************************/
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include "bounded_integers.h"
+#include "bytecode.h"
+
+/************************************ Types ********************************************/
+/**
+ * @brief the patch that fixes a program and the result of running the fixed program
+*/
+struct Repair
+{
+   std::size_t index{0};                       //!< the instruction that was swapped
+   Instructions original{Instructions::nop};   //!< what it was before the swap
+   int64_t accumulator{0};                     //!< accumulator when the patched program terminates
+};
+
+
+/****************************** Function Definitions ***********************************/
+/**
+ * @brief get the instruction that runs after another one
+ * @param instruction the opcode
+ * @param operand the operand
+ * @param index the instruction index
+ * @return index of the next instruction (may be out of bounds)
+*/
+constexpr int64_t next_instruction(Instructions instruction, int32_t operand, int64_t index)
+{
+   return index + ((instruction == Instructions::jmp) ? operand : 1);
+}
+
+/**
+ * @brief find every instruction that runs to a clean exit without any patching
+ * @details each instruction has exactly one successor, so the instructions that terminate are the ones that can be
+ *          reached backwards from the exit (index size). The predecessor lists are built in compressed sparse row form
+ *          with a counting pass, then walked once from the exit. O(n) time and memory.
+ * @param program the program
+ * @return set over [0, size] with the exit itself included
+*/
+inline DenseBitset find_terminating(const Program& program)
+{
+   const std::size_t size = program.size();
+   auto successor = [&program](std::size_t index) {
+      return next_instruction(Program::opcode(program.code[index]), Program::operand(program.code[index]), static_cast<int64_t>(index));
+   };
+   auto in_bounds = [size](int64_t target) { return (target >= 0) && (static_cast<uint64_t>(target) <= size); };
+
+   /* predecessor lists of every node in [0, size] */
+   std::vector<std::size_t> offsets(size + 2, 0);
+   for (std::size_t i = 0; i < size; i++)
+   {
+      auto target = successor(i);
+      if (in_bounds(target))
+      {
+         offsets[static_cast<std::size_t>(target) + 1]++;
+      }
+   }
+   for (std::size_t node = 0; node <= size; node++)
+   {
+      offsets[node + 1] += offsets[node];
+   }
+   std::vector<uint32_t> predecessors(offsets[size + 1]);
+   std::vector<std::size_t> next(offsets.begin(), offsets.end() - 1);
+   for (std::size_t i = 0; i < size; i++)
+   {
+      auto target = successor(i);
+      if (in_bounds(target))
+      {
+         predecessors[next[static_cast<std::size_t>(target)]++] = static_cast<uint32_t>(i);
+      }
+   }
+
+   /* walk back from the exit. Every node has one successor so nothing is reached twice */
+   DenseBitset terminating{ size + 1 };
+   terminating.set(size);
+   std::vector<std::size_t> worklist{ size };
+   while (!worklist.empty())
+   {
+      const std::size_t node = worklist.back();
+      worklist.pop_back();
+      for (std::size_t p = offsets[node]; p < offsets[node + 1]; p++)
+      {
+         if (!terminating.test(predecessors[p]))
+         {
+            terminating.set(predecessors[p]);
+            worklist.push_back(predecessors[p]);
+         }
+      }
+   }
+   return terminating;
+}
+
+/**
+ * @brief find the single nop/jmp swap that makes a program terminate
+ * @details the program is run forwards once. At each nop or jmp the swapped successor is looked up in the
+ *          terminating set, and the first one that lands in it is the fix: the rest of the run follows the patched
+ *          path to the exit. Only the instructions on the original path can be the broken one, so this is O(n) overall.
+ * @param program the program
+ * @return the repair, or nullopt if no single swap on the executed path fixes the program
+*/
+inline std::optional<Repair> find_repair(const Program& program)
+{
+   const auto terminating = find_terminating(program);
+   const std::size_t size = program.size();
+   DenseBitset visited{ size };
+
+   int64_t accumulator{0};
+   int64_t pc{0};
+   std::optional<Repair> repair;
+   while ((pc >= 0) && (static_cast<uint64_t>(pc) < size) && !visited.test(static_cast<std::size_t>(pc)))
+   {
+      visited.set(static_cast<std::size_t>(pc));
+      const uint32_t word = program.code[pc];
+      Instructions instruction = Program::opcode(word);
+      const int32_t operand = Program::operand(word);
+
+      if (!repair.has_value() && (instruction != Instructions::acc))
+      {
+         const Instructions swapped = (instruction == Instructions::jmp) ? Instructions::nop : Instructions::jmp;
+         const int64_t target = next_instruction(swapped, operand, pc);
+         if ((target >= 0) && (static_cast<uint64_t>(target) <= size) && terminating.test(static_cast<std::size_t>(target)))
+         {
+            repair = Repair{ static_cast<std::size_t>(pc), instruction, 0 };
+            instruction = swapped;
+         }
+      }
+
+      accumulator += (instruction == Instructions::acc) ? operand : 0;
+      pc = next_instruction(instruction, operand, pc);
+   }
+
+   if (!repair.has_value() || (static_cast<uint64_t>(pc) != size))
+   {
+      return std::nullopt;
+   }
+   repair->accumulator = accumulator;
+   return repair;
+}
@@ -0,0 +1,175 @@
+/*! \file speculative.h
+*
+*  \brief run many patched versions of a program at once on a thread pool, stopping as soon as one terminates
+*
+*  \author Graham Riches
+*/
+
+#pragma once
+
+/********************************** Includes *******************************************/
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <optional>
+#include <vector>
+#include "bytecode.h"
+#include "thread_pool.h"
+
+/************************************ Types ********************************************/
+/**
+ * @brief replacement of a single encoded instruction
+*/
+struct Patch
+{
+   std::size_t index{0};
+   uint32_t word{0};
+};
+
+
+/**
+ * @brief copy on write view of a program: reads fall through to the shared base program unless the instruction has
+ *        been patched, so a candidate costs a few words rather than a full copy of the program
+*/
+class PatchedProgram
+{
+public:
+   /**
+    * @brief create an overlay
+    * @param base the program to patch. Must outlive the overlay
+    * @param patches the patched instructions. Later patches to the same index win
+   */
+   PatchedProgram(const Program& base, const std::vector<Patch>& patches)
+      : base(base), patches(patches)
+   {}
+
+   std::size_t size(void) const
+   {
+      return this->base.size();
+   }
+
+   /**
+    * @brief fetch an encoded instruction
+    * @param index the instruction index (must be in bounds)
+    * @return the patched word if there is one, otherwise the base word
+   */
+   uint32_t operator[](std::size_t index) const
+   {
+      for (auto patch = this->patches.rbegin(); patch != this->patches.rend(); patch++)
+      {
+         if (patch->index == index)
+         {
+            return patch->word;
+         }
+      }
+      return this->base.code[index];
+   }
+
+private:
+   const Program& base;
+   const std::vector<Patch>& patches;
+};
+
+
+/**
+ * @brief the first candidate (lowest index) whose patched program terminates
+*/
+struct SpeculativeResult
+{
+   std::size_t candidate{0};
+   RunResult run;
+};
+
+
+/****************************** Function Definitions ***********************************/
+/**
+ * @brief try a list of candidate patch sets in parallel
+ * @details each worker pulls the next candidate off a shared counter and runs it with the normal interpreter over a
+ *          copy on write overlay of the shared program, using its own visited bits. After each run only the bits that
+ *          run set are cleared again. The lowest terminating candidate found so far is published through an atomic.
+ *          Runs go in slices of a few thousand steps, and every worker drops (or stops running) any candidate above the
+ *          published one, so the search winds down as soon as a fix is found while still reporting the same
+ *          candidate as a sequential search would.
+ * @param program the base program
+ * @param candidates the patch sets to try
+ * @param pool the pool to run on
+ * @return the lowest numbered candidate that terminates, or nullopt if none do
+*/
+inline std::optional<SpeculativeResult> run_speculative(const Program& program, const std::vector<std::vector<Patch>>& candidates, ThreadPool& pool)
+{
+   static constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+   static constexpr uint64_t cancel_interval = 4096;
+   std::atomic<std::size_t> next_candidate{0};
+   std::atomic<std::size_t> best{none};
+
+   auto worker = [&]()
+   {
+      std::optional<SpeculativeResult> found;
+      std::vector<uint64_t> visited((program.size() + 63) / 64, 0);
+      NullTracer tracer;
+      for (std::size_t candidate = next_candidate++; candidate < std::min(candidates.size(), best.load()); candidate = next_candidate++)
+      {
+         PatchedProgram overlay{ program, candidates[candidate] };
+         RunResult result;
+         uint64_t steps{0};
+         do
+         {
+            result = execute(overlay, visited, tracer, result.last, result.accumulator, cancel_interval);
+            steps += result.steps;
+         } while ((result.status == RunStatus::step_limit) && (best.load(std::memory_order_relaxed) > candidate));
+         result.steps = steps;
+         clear_visited(overlay, visited, 0, steps);
+         if (result.status != RunStatus::terminated)
+         {
+            continue;
+         }
+
+         /* publish the new lowest terminating candidate */
+         std::size_t current = best.load();
+         while ((candidate < current) && !best.compare_exchange_weak(current, candidate)) {}
+         found = SpeculativeResult{ candidate, result };
+      }
+      return found;
+   };
+
+   std::vector<std::future<std::optional<SpeculativeResult>>> workers;
+   for (std::size_t i = 0; i < pool.size(); i++)
+   {
+      workers.push_back(pool.submit(worker));
+   }
+
+   std::optional<SpeculativeResult> winner;
+   for (auto& result : workers)
+   {
+      auto found = result.get();
+      if (found.has_value() && (!winner.has_value() || (found->candidate < winner->candidate)))
+      {
+         winner = found;
+      }
+   }
+   return winner;
+}
+
+/**
+ * @brief build every single nop/jmp swap of a program as a candidate patch set
+ * @param program the program
+ * @return one candidate per nop or jmp, in program order
+*/
+inline std::vector<std::vector<Patch>> single_swap_candidates(const Program& program)
+{
+   std::vector<std::vector<Patch>> candidates;
+   for (std::size_t i = 0; i < program.size(); i++)
+   {
+      const uint32_t word = program.code[i];
+      const Instructions instruction = Program::opcode(word);
+      if (instruction != Instructions::acc)
+      {
+         const Instructions swapped = (instruction == Instructions::jmp) ? Instructions::nop : Instructions::jmp;
+         candidates.push_back({ Patch{ i, Program::encode(swapped, Program::operand(word)) } });
+      }
+   }
+   return candidates;
+}
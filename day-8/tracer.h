@@ -0,0 +1,120 @@
+/*! \file tracer.h
+*
+*  \brief profiling tracer for the boot code interpreter
+*
+*  \author Graham Riches
+*/
+
+#pragma once
+
+/********************************** Includes *******************************************/
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+#include "bytecode.h"
+
+/************************************ Types ********************************************/
+/**
+ * @brief one executed instruction in the binary trace
+*/
+struct TraceEntry
+{
+   uint32_t pc{0};
+   uint32_t word{0};          //!< the encoded instruction
+   int64_t accumulator{0};    //!< accumulator before the instruction ran
+};
+
+
+/**
+ * @brief tracer that records where the time goes in a run
+ * @details keeps an execution count per instruction, a taken count per jmp instruction, how long the last run
+ *          took, and the most recent instructions in a fixed size ring buffer that can be written out as raw
+ *          TraceEntry records for offline tools
+*/
+class ProfilingTracer
+{
+public:
+   static constexpr bool enabled = true;
+
+   std::vector<uint64_t> execution_counts;        //!< times each instruction ran, summed over every run
+   std::map<std::size_t, uint64_t> jump_counts;   //!< pc of each jmp -> times taken, summed over every run
+   std::chrono::nanoseconds last_run_time{0};
+
+   /**
+    * @brief create a tracer
+    * @param trace_capacity number of trace entries to keep. Rounded up to a power of two
+   */
+   explicit ProfilingTracer(std::size_t trace_capacity = 4096)
+   {
+      std::size_t capacity = 1;
+      while (capacity < trace_capacity)
+      {
+         capacity <<= 1;
+      }
+      this->trace.resize(capacity);
+   }
+
+   void on_start(std::size_t program_size, int64_t)
+   {
+      this->execution_counts.resize(program_size, 0);
+      this->start_time = std::chrono::steady_clock::now();
+   }
+
+   void on_execute(int64_t pc, uint32_t word, int64_t accumulator)
+   {
+      this->execution_counts[static_cast<std::size_t>(pc)]++;
+      this->trace[this->trace_head & (this->trace.size() - 1)] = TraceEntry{ static_cast<uint32_t>(pc), word, accumulator };
+      this->trace_head++;
+   }
+
+   void on_jump(int64_t pc, int32_t)
+   {
+      this->jump_counts[static_cast<std::size_t>(pc)]++;
+   }
+
+   void on_finish(const RunResult&)
+   {
+      this->last_run_time = std::chrono::steady_clock::now() - this->start_time;
+   }
+
+   /**
+    * @brief get the number of entries currently held in the trace
+    * @return entry count
+   */
+   std::size_t trace_size(void) const
+   {
+      return (this->trace_head < this->trace.size()) ? static_cast<std::size_t>(this->trace_head) : this->trace.size();
+   }
+
+   /**
+    * @brief write the trace to a file, oldest entry first
+    * @details the file is a uint64_t entry count followed by that many raw TraceEntry records in host byte order
+    * @param path the file to write
+    * @return true if the file was written
+   */
+   bool dump(const std::string& path) const
+   {
+      std::ofstream stream{ path, std::ios::binary };
+      if (!stream)
+      {
+         return false;
+      }
+      const uint64_t count = this->trace_size();
+      stream.write(reinterpret_cast<const char*>(&count), sizeof(count));
+      const std::size_t mask = this->trace.size() - 1;
+      for (uint64_t i = this->trace_head - count; i < this->trace_head; i++)
+      {
+         stream.write(reinterpret_cast<const char*>(&this->trace[i & mask]), sizeof(TraceEntry));
+      }
+      return static_cast<bool>(stream);
+   }
+
+private:
+   std::vector<TraceEntry> trace;
+   uint64_t trace_head{0};         //!< total entries ever written; the next slot is trace_head & (capacity - 1)
+   std::chrono::steady_clock::time_point start_time;
+};
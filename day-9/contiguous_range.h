@@ -0,0 +1,137 @@
+/*! \file contiguous_range.h
+*
+*  \brief single pass search for a contiguous run of numbers in a stream that adds up to a target
+*
+*  \author Graham Riches
+*/
+
+#pragma once
+
+/********************************** Includes *******************************************/
+#include <cstddef>
+#include <deque>
+#include <optional>
+#include <utility>
+
+/************************************ Types ********************************************/
+/**
+ * @brief bounds of a contiguous range in a stream (inclusive) along with the smallest and largest values in it
+ * @tparam T the value type
+*/
+template <typename T>
+struct ContiguousRange
+{
+   std::size_t first{0};
+   std::size_t last{0};
+   T min{};
+   T max{};
+};
+
+
+/**
+ * @brief two pointer search for a contiguous range summing to a target
+ * @details values are pushed one at a time. The running window grows at the back and shrinks from
+ *          the front whenever the sum overshoots, so each value is added and removed at most once. Two
+ *          monotonic queues track the window minimum and maximum so they are ready as soon as the range is found.
+ *          Only the current window is held in memory, never the whole stream.
+ * @note the two pointer shrink is only valid for non-negative values
+ * @tparam T the value type
+*/
+template <typename T>
+class ContiguousSumFinder
+{
+public:
+   /**
+    * @brief create a new finder
+    * @param target the sum to look for
+    * @param minimum_length the smallest number of values a range must have
+   */
+   explicit ContiguousSumFinder(T target, std::size_t minimum_length = 2)
+      : target(target), minimum_length(minimum_length)
+   {}
+
+   /**
+    * @brief push the next value in the stream
+    * @param value the value
+    * @return the range once the values pushed so far end in a matching range, nullopt otherwise
+   */
+   std::optional<ContiguousRange<T>> push(T value)
+   {
+      const std::size_t index = this->next_index++;
+      this->window.push_back(value);
+      this->sum += value;
+
+      while (!this->minimums.empty() && (this->minimums.back().second >= value))
+      {
+         this->minimums.pop_back();
+      }
+      this->minimums.emplace_back(index, value);
+      while (!this->maximums.empty() && (this->maximums.back().second <= value))
+      {
+         this->maximums.pop_back();
+      }
+      this->maximums.emplace_back(index, value);
+
+      while ((this->sum > this->target) && !this->window.empty())
+      {
+         this->pop_front();
+      }
+
+      if ((this->sum == this->target) && (this->window.size() >= this->minimum_length))
+      {
+         return ContiguousRange<T>{ this->first_index, index, this->minimums.front().second, this->maximums.front().second };
+      }
+      return std::nullopt;
+   }
+
+private:
+   T target{};
+   std::size_t minimum_length{2};
+   T sum{};
+   std::size_t first_index{0};                         //!< stream index of the front of the window
+   std::size_t next_index{0};                          //!< stream index of the next value pushed
+   std::deque<T> window;
+   std::deque<std::pair<std::size_t, T>> minimums;     //!< increasing values, front is the window minimum
+   std::deque<std::pair<std::size_t, T>> maximums;     //!< decreasing values, front is the window maximum
+
+   /**
+    * @brief drop the value at the front of the window
+   */
+   void pop_front(void)
+   {
+      this->sum -= this->window.front();
+      this->window.pop_front();
+      if (this->minimums.front().first == this->first_index)
+      {
+         this->minimums.pop_front();
+      }
+      if (this->maximums.front().first == this->first_index)
+      {
+         this->maximums.pop_front();
+      }
+      this->first_index++;
+   }
+};
+
+
+/**
+ * @brief find the first contiguous range in a stream of values that adds up to a target
+ * @tparam Range input range of values
+ * @tparam T the value type
+ * @param values the values. Only a single pass is made over them
+ * @param target the sum to look for
+ * @return the range, or nullopt if there isn't one
+*/
+template <typename Range, typename T>
+std::optional<ContiguousRange<T>> find_contiguous_range(Range&& values, T target)
+{
+   ContiguousSumFinder<T> finder{ target };
+   for (auto value : values)
+   {
+      if (auto range = finder.push(value))
+      {
+         return range;
+      }
+   }
+   return std::nullopt;
+}
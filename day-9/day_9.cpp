@@ -14,6 +14,13 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <charconv>
+#include <optional>
+#include <ranges>
+#include <string_view>
+#include "contiguous_range.h"
+#include "pair_sum_window.h"
+#include "string_utilities.h"
 
 
 /*********************************** Consts ********************************************/
@@ -29,65 +36,24 @@
 
 /****************************** Functions Prototype **************************************/
 /**
- * @brief get all pair combinations from a vector
- * @details this returns all possible permutations of two elements in the list excluding
- *          pairs of the same item. Note, order does not matter (i.e. AB is considered equal to BA)
- * @tparam T the type of the pair
- * @param elements range of elements
- * @return vector of pairs
+ * @brief find the first value that is not the sum of two values in the preamble before it
+ * @param values range of values to process. Only a single pass is made over them
+ * @param preamble_size number of values in the preamble
+ * @return the first invalid value, or nullopt if every value is valid
 */
-template <typename T>
-std::vector<std::pair<T, T>> get_pair_combinations(std::vector<T> elements)
+template <typename Range>
+std::optional<int64_t> find_first_invalid(Range&& values, std::size_t preamble_size)
 {
-   std::vector<std::pair<T, T>> pairs;
-   for (int i = 0; i < elements.size(); i++)
+   PairSumWindow<int64_t> window{ preamble_size };
+   for (int64_t value : values)
    {
-      for (int j = i + 1; j < elements.size(); j++)
+      if (window.is_full() && !window.contains_sum(value))
       {
-         pairs.push_back(std::pair<T, T>{ elements[i], elements[j] });
+         return value;
       }
+      window.push(value);
    }
-   return pairs;
-}
-
-
-/**
- * @brief check if the sum of any two numbers in the list equals the input value
- * @param value 
- * @param list 
- * @return 
-*/
-bool sum_contained_in( const int64_t value, const std::vector<int64_t>& list )
-{
-   auto pairs = get_pair_combinations( list );
-   auto result = std::transform_reduce( pairs.cbegin(), pairs.cend(), 0L,
-                                        std::plus<>(),
-                                        [value](auto &p){ return ( p.first + p.second) == value; }
-                                       );
-   return static_cast<bool>(result);
-}
-
-
-/**
- * @brief process input data based on a fixed preamble size
- * @param values the values to process
- * @param preamble_size number of preamble bytes
- * @return valid entry for each element in the input vector
-*/
-std::vector<bool> process_from_preamble(std::vector<int64_t>& values, int64_t preamble_size)
-{
-   std::vector<bool> results( values.size() );
-   std::fill(results.begin(), results.begin() + preamble_size, true );
-   std::transform(values.cbegin() + preamble_size, values.cend(), results.begin() + preamble_size, 
-      [preamble_size, values, count = 0]( const int &a) mutable
-      {         
-         auto sub_array = std::vector<int64_t>{values.begin() + count, values.begin() + preamble_size + count};
-         count++;
-         auto result = sum_contained_in(a, sub_array);
-         return result;
-      }
-   );
-   return results;
+   return std::nullopt;
 }
 
 /****************************** Functions Definition ***********************************/
@@ -99,48 +65,34 @@ std::vector<bool> process_from_preamble(std::vector<int64_t>& values, int64_t pr
 */
 int main( int argc, char *argv[] )
 {     
-   /* read in the data */
-   std::ifstream stream{ argv[1] };
-   std::string line;
-   std::vector<int64_t> values;
-   while (std::getline(stream, line))
+   /* stream the values straight out of the mapped file: nothing is stored */
+   MappedFile file = open_file( argv[1] );
+   auto to_int64 = [](std::string_view line)
    {
-      values.push_back( std::stoll(line) ); /* convert to int64 to not overflow */
-   }
+      int64_t value{0}; /* int64 to not overflow */
+      std::from_chars(line.data(), line.data() + line.size(), value);
+      return value;
+   };
+   auto values = file.lines() | std::views::transform(to_int64);
 
-   /* part one solution */
-   auto sum_in_previous = process_from_preamble( values, 25 );
-   auto index = std::find( sum_in_previous.cbegin(), sum_in_previous.cend(), false ) - sum_in_previous.cbegin();   
-   int invalid_number = values[index];
-   std::cout << "First value not contained in previous preamble " << invalid_number << std::endl;
+   /* the preamble size can be overridden from the command line */
+   std::size_t preamble_size = ( argc > 2 ) ? std::stoul( argv[2] ) : 25;
 
-   /* part two solution */
-   std::vector<bool> contains_invalid_number;
-   std::transform(values.cbegin(), values.cend(), std::back_inserter(contains_invalid_number),
-      [invalid_number, values, count = 0](auto & val) mutable 
-      {
-         std::vector<int64_t> running_sum{ values.begin() + count, values.end() };
-         std::partial_sum( running_sum.begin(), running_sum.end(), running_sum.begin());
-         auto it = std::find(running_sum.cbegin(), running_sum.cend(), invalid_number );
-         count++;
-         return ( it != running_sum.end() );
-      }
-   );
-
-   auto start_index = std::find(contains_invalid_number.cbegin(), contains_invalid_number.cend(), true ) - contains_invalid_number.cbegin();  
-
-   /* gross while loop - could probably do with an STL algorithm? */
-   int min_value = values[start_index];
-   int max_value = values[start_index];
-   int sum = 0;
-   while (sum != invalid_number)
+   /* part one solution */
+   auto invalid_number = find_first_invalid( values, preamble_size );
+   if ( !invalid_number )
    {
-      min_value = ( values[start_index] < min_value) ? values[start_index] : min_value;
-      max_value = ( values[start_index] > max_value ) ? values[start_index] : max_value;
-      sum += values[start_index++];
+      std::cout << "Every value is contained in its preamble" << std::endl;
+      return 0;
    }
+   std::cout << "First value not contained in previous preamble " << *invalid_number << std::endl;
 
-   std::cout << "sum of largest and smallest values: " << min_value + max_value << "\n";
+   /* part two solution: second pass over the stream with a two pointer window */
+   auto range = find_contiguous_range( values, *invalid_number );
+   if ( range )
+   {
+      std::cout << "sum of largest and smallest values: " << range->min + range->max << "\n";
+   }
    
    return 0;
 }
@@ -0,0 +1,112 @@
+/*! \file pair_sum_window.h
+*
+*  \brief sliding window over a stream of numbers that can tell if any two numbers in the
+*         window add up to a value without re-checking every pair
+*
+*  \author Graham Riches
+*/
+
+#pragma once
+
+/********************************** Includes *******************************************/
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+/************************************ Types ********************************************/
+/**
+ * @brief sliding window that keeps a count of every pairwise sum of the values inside it
+ * @details pushing a value evicts the oldest one once the window is full, which removes the window - 1
+ *          sums it was part of and adds the window - 1 sums for the new value. Checking a sum is then a
+ *          single hash lookup instead of a scan over every pair.
+ * @tparam T the value type
+*/
+template <typename T>
+class PairSumWindow
+{
+public:
+   /**
+    * @brief create an empty window
+    * @param window_size number of values to keep (the preamble size)
+   */
+   explicit PairSumWindow(std::size_t window_size)
+      : window_size(window_size), values(window_size)
+   {
+      /* a full window holds at most one distinct sum per pair */
+      this->sums.reserve(window_size * (window_size - (window_size > 0)) / 2);
+   }
+
+   /**
+    * @brief check if the window holds a full preamble yet
+    * @return true if full
+   */
+   bool is_full(void) const
+   {
+      return this->count == this->window_size;
+   }
+
+   /**
+    * @brief check if two different entries in the window sum to a value
+    * @param value the sum to look for
+    * @return true if there is a pair
+   */
+   bool contains_sum(T value) const
+   {
+      return this->sums.find(value) != this->sums.end();
+   }
+
+   /**
+    * @brief push a new value into the window, evicting the oldest value once it is full
+    * @param value the value to add
+   */
+   void push(T value)
+   {
+      if (this->window_size == 0)
+      {
+         return;
+      }
+
+      /* slot head holds the oldest value once the window is full */
+      if (this->is_full())
+      {
+         const T oldest = this->values[this->head];
+         for (std::size_t i = 0; i < this->window_size; i++)
+         {
+            if (i != this->head)
+            {
+               this->remove_sum(oldest + this->values[i]);
+            }
+         }
+         this->count--;
+      }
+
+      for (std::size_t i = 0; i < this->count; i++)
+      {
+         auto slot = (this->head + this->window_size - 1 - i) % this->window_size;
+         this->sums[value + this->values[slot]]++;
+      }
+      this->values[this->head] = value;
+      this->head = (this->head + 1) % this->window_size;
+      this->count++;
+   }
+
+private:
+   std::size_t window_size{0};
+   std::vector<T> values;                       //!< ring buffer of the window values
+   std::size_t head{0};                         //!< next slot to write to
+   std::size_t count{0};                        //!< number of values in the window
+   std::unordered_map<T, std::size_t> sums;     //!< count of each pairwise sum in the window
+
+   /**
+    * @brief drop one instance of a pairwise sum
+    * @param sum the sum to remove
+   */
+   void remove_sum(T sum)
+   {
+      auto it = this->sums.find(sum);
+      if (--it->second == 0)
+      {
+         this->sums.erase(it);
+      }
+   }
+};
@@ -0,0 +1,123 @@
+/*! \file bounded_integers_tests.cpp
+*
+*  \brief tests for the bounded integer tools
+*
+*
+*  \author Graham Riches
+*/
+
+/********************************** Includes *******************************************/
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include "bounded_integers.h"
+
+
+/**
+ * @test setting, clearing and finding values across word boundaries
+*/
+TEST( bounded_integers_tests, test_dense_bitset_set_and_search )
+{
+   DenseBitset set{ 200 };
+   EXPECT_FALSE( set.first( ).has_value( ) );
+   EXPECT_FALSE( set.last( ).has_value( ) );
+
+   for ( std::size_t value : { 3, 63, 64, 130, 199 } )
+   {
+      set.set( value );
+   }
+   set.reset( 3 );
+   EXPECT_EQ( 4u, set.count( ) );
+   EXPECT_FALSE( set.test( 3 ) );
+   EXPECT_TRUE( set.test( 64 ) );
+   EXPECT_EQ( 63u, *set.first( ) );
+   EXPECT_EQ( 199u, *set.last( ) );
+   EXPECT_EQ( 130u, *set.next( 65 ) );
+   EXPECT_FALSE( set.next( 200 ).has_value( ) );
+
+   std::vector<std::size_t> visited;
+   set.for_each( [&visited]( std::size_t value ) { visited.push_back( value ); } );
+   EXPECT_EQ( ( std::vector<std::size_t>{ 63, 64, 130, 199 } ), visited );
+}
+
+/**
+ * @test only single missing values with both neighbours present count as gaps, including across words
+*/
+TEST( bounded_integers_tests, test_dense_bitset_isolated_gaps )
+{
+   std::vector<int> values;
+   for ( int value = 10; value < 140; value++ )
+   {
+      if ( ( value != 64 ) && ( value != 100 ) && ( value != 101 ) )
+      {
+         values.push_back( value );
+      }
+   }
+   auto set = DenseBitset::from_values( values );
+   EXPECT_EQ( 140u, set.size( ) );
+   EXPECT_EQ( ( std::vector<std::size_t>{ 64 } ), set.isolated_gaps( ) );
+}
+
+/**
+ * @test histogram of the spacing between consecutive values
+*/
+TEST( bounded_integers_tests, test_dense_bitset_delta_histogram )
+{
+   std::vector<int> values{ 0, 16, 10, 15, 5, 1, 11, 7, 19, 6, 12, 4, 22 };
+   auto histogram = DenseBitset::from_values( values ).delta_histogram( );
+   ASSERT_EQ( 4u, histogram.size( ) );
+   EXPECT_EQ( 7u, histogram[1] );
+   EXPECT_EQ( 0u, histogram[2] );
+   EXPECT_EQ( 5u, histogram[3] );
+}
+
+/**
+ * @test counting sort keeps duplicates and handles negative ranges
+*/
+TEST( bounded_integers_tests, test_counting_sort )
+{
+   std::vector<int> values{ 5, -3, 9, 5, 0, -3, 2 };
+   auto expected = values;
+   std::sort( expected.begin( ), expected.end( ) );
+   counting_sort( values );
+   EXPECT_EQ( expected, values );
+
+   std::vector<int> empty;
+   counting_sort( empty );
+   EXPECT_TRUE( empty.empty( ) );
+}
+
+/**
+ * @test counting sort works out the range without overflowing and falls back to std::sort for sparse values
+*/
+TEST( bounded_integers_tests, test_counting_sort_wide_ranges )
+{
+   std::vector<int> extremes{ std::numeric_limits<int>::max( ), 0, std::numeric_limits<int>::min( ), -1, 1 };
+   auto expected = extremes;
+   std::sort( expected.begin( ), expected.end( ) );
+   counting_sort( extremes );
+   EXPECT_EQ( expected, extremes );
+
+   std::vector<int8_t> bytes{ 127, -128, 0, -1, 127 };
+   counting_sort( bytes, int8_t{ -128 }, int8_t{ 127 } );
+   EXPECT_EQ( ( std::vector<int8_t>{ -128, -1, 0, 127, 127 } ), bytes );
+
+   std::vector<uint64_t> sparse{ uint64_t{ 1 } << 60, 3, uint64_t{ 1 } << 40, 3 };
+   counting_sort( sparse );
+   EXPECT_EQ( ( std::vector<uint64_t>{ 3, 3, uint64_t{ 1 } << 40, uint64_t{ 1 } << 60 } ), sparse );
+}
+
+/**
+ * @test building a bitset from negative values is rejected rather than resizing to a huge range
+*/
+TEST( bounded_integers_tests, test_dense_bitset_rejects_negative_values )
+{
+   std::vector<int> values{ 3, -1, 5 };
+   EXPECT_THROW( DenseBitset::from_values( values ), std::out_of_range );
+
+   std::vector<int> valid{ 3, 0, 5 };
+   EXPECT_EQ( 3u, DenseBitset::from_values( valid ).count( ) );
+}
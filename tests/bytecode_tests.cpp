@@ -0,0 +1,73 @@
+/*! \file bytecode_tests.cpp
+*
+*  \brief tests for the day 8 boot code encoding and parser
+*
+*
+*  \author Graham Riches
+*/
+
+/********************************** Includes *******************************************/
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include "bytecode.h"
+
+
+/**
+ * @brief parse a buffer and report the line that failed
+ * @param buffer the buffer
+ * @return the failing line number, or 0 if the parse succeeded
+*/
+static std::size_t failing_line(const std::string& buffer)
+{
+   std::size_t line{0};
+   return Program::parse(buffer, &line).has_value() ? 0 : line;
+}
+
+
+/**
+ * @test every opcode and both signs survive the encoding, including the ends of the operand range
+*/
+TEST(bytecode_tests, test_parse_round_trip)
+{
+   auto program = Program::parse("nop +0\nacc -99\njmp +4\r\nacc +536870911\njmp -536870912\n");
+   ASSERT_TRUE(program.has_value());
+   ASSERT_EQ(5u, program->size());
+   EXPECT_EQ(Instructions::nop, Program::opcode((*program)[0]));
+   EXPECT_EQ(Instructions::acc, Program::opcode((*program)[1]));
+   EXPECT_EQ(-99, Program::operand((*program)[1]));
+   EXPECT_EQ(Instructions::jmp, Program::opcode((*program)[2]));
+   EXPECT_EQ(4, Program::operand((*program)[2]));
+   EXPECT_EQ(Program::operand_max, Program::operand((*program)[3]));
+   EXPECT_EQ(Program::operand_min, Program::operand((*program)[4]));
+}
+
+/**
+ * @test blank lines are skipped without shifting the instruction indices of the lines after them
+*/
+TEST(bytecode_tests, test_parse_skips_blank_lines)
+{
+   auto program = Program::parse("\nnop +0\n   \n\r\njmp -1\n\n");
+   ASSERT_TRUE(program.has_value());
+   ASSERT_EQ(2u, program->size());
+   EXPECT_EQ(Instructions::jmp, Program::opcode((*program)[1]));
+}
+
+/**
+ * @test every kind of malformed line fails the parse and reports its line number
+*/
+TEST(bytecode_tests, test_parse_rejects_malformed_lines)
+{
+   EXPECT_EQ(0u, failing_line("nop +0\nacc +1\n"));
+   EXPECT_EQ(2u, failing_line("nop +0\nacc\n"));                     //!< too short
+   EXPECT_EQ(2u, failing_line("nop +0\nacc+1234\n"));                //!< no space after the opcode
+   EXPECT_EQ(1u, failing_line("mul +2\nnop +0\n"));                  //!< unknown opcode
+   EXPECT_EQ(3u, failing_line("nop +0\n\njmp +x\n"));                //!< operand isn't a number
+   EXPECT_EQ(1u, failing_line("acc +12abc\n"));                      //!< trailing junk after the operand
+   EXPECT_EQ(1u, failing_line("acc +-5\n"));                         //!< two signs
+   EXPECT_EQ(1u, failing_line("acc  +5\n"));                         //!< extra space before the operand
+   EXPECT_EQ(2u, failing_line("nop +0\nacc +536870912\n"));          //!< above operand_max
+   EXPECT_EQ(1u, failing_line("jmp -536870913\n"));                  //!< below operand_min
+   EXPECT_EQ(1u, failing_line("jmp +99999999999999999999\n"));       //!< too big for any integer
+}
@@ -0,0 +1,97 @@
+/*! \file combinations_tests.cpp
+*
+*  \brief tests for the combination generators
+*
+*
+*  \author Graham Riches
+*/
+
+/********************************** Includes *******************************************/
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <vector>
+#include "combinations.h"
+
+
+/**
+ * @test that the lazy range produces the same combinations as the materialised version
+*/
+TEST( combinations_tests, test_lazy_triplets_match_materialised_triplets )
+{
+   std::vector<int> elements{ 1, 2, 3, 4, 5, 6 };
+   auto expected = get_triplet_combinations( elements );
+
+   std::vector<std::vector<int>> actual;
+   for ( const auto &combination : combinations( elements, 3 ) )
+   {
+      actual.push_back( combination );
+   }
+   EXPECT_EQ( expected, actual );
+}
+
+/**
+ * @test that a search stops at the first match and reports its positions
+*/
+TEST( combinations_tests, test_find_stops_at_first_match )
+{
+   std::vector<int> elements{ 1721, 979, 366, 299, 675, 1456 };
+   auto pairs = combinations( elements, 2 );
+   auto match = std::ranges::find_if( pairs, []( const auto &p ) { return ( p[0] + p[1] ) == 2020; } );
+   ASSERT_NE( pairs.end( ), match );
+   EXPECT_EQ( 1721, ( *match )[0] );
+   EXPECT_EQ( 299, ( *match )[1] );
+   EXPECT_EQ( ( std::vector<std::size_t>{ 0, 3 } ), match.positions( ) );
+}
+
+/**
+ * @test that asking for more elements than exist gives an empty range
+*/
+TEST( combinations_tests, test_k_larger_than_input_is_empty )
+{
+   std::vector<int> elements{ 1, 2 };
+   auto range = combinations( elements, 3 );
+   EXPECT_TRUE( range.begin( ) == range.end( ) );
+}
+
+/**
+ * @test that the parallel version visits every combination exactly once
+*/
+TEST( combinations_tests, test_parallel_for_each_visits_every_combination )
+{
+   std::vector<int> elements( 20 );
+   std::iota( elements.begin( ), elements.end( ), 0 );
+
+   std::atomic<long> count{ 0 };
+   std::atomic<long> total{ 0 };
+   bool stopped = for_each_combination( elements, 3, [&]( const std::vector<int> &c ) {
+      count++;
+      total += c[0] + c[1] + c[2];
+      return false;
+   }, 4 );
+
+   EXPECT_FALSE( stopped );
+   EXPECT_EQ( 1140, count );          //!< 20 choose 3
+   EXPECT_EQ( 1140 * 3 * 19 / 2, total ); //!< each element shows up in 3/20 of the combinations
+}
+
+/**
+ * @test that the parallel version stops once a match is found
+*/
+TEST( combinations_tests, test_parallel_for_each_stops_early )
+{
+   std::vector<int> elements{ 1721, 979, 366, 299, 675, 1456 };
+   std::atomic<int> product{ 0 };
+   bool stopped = for_each_combination( elements, 3, [&]( const std::vector<int> &c ) {
+      if ( ( c[0] + c[1] + c[2] ) == 2020 )
+      {
+         product = c[0] * c[1] * c[2];
+         return true;
+      }
+      return false;
+   }, 3 );
+
+   EXPECT_TRUE( stopped );
+   EXPECT_EQ( 241861950, product );
+}
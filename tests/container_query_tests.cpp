@@ -0,0 +1,126 @@
+/*! \file container_query_tests.cpp
+*
+*  \brief tests for the day 7 bag graph container queries
+*
+*
+*  \author Graham Riches
+*/
+
+/********************************** Includes *******************************************/
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+#include "bag_graph.h"
+#include "container_query.h"
+
+
+/**
+ * @brief build rule lines for a random bag graph
+ * @param bag_count number of bags
+ * @param seed random seed
+ * @return the rules, one per bag
+*/
+static std::vector<std::string> random_rules(std::size_t bag_count, uint32_t seed)
+{
+   std::mt19937 generator{ seed };
+   std::vector<std::string> rules;
+   for (std::size_t bag = 0; bag < bag_count; bag++)
+   {
+      std::string rule = "shade " + std::to_string(bag) + " bags contain ";
+      const auto children = generator() % 4;
+      if (children == 0)
+      {
+         rule += "no other bags.";
+      }
+      for (uint32_t child = 0; child < children; child++)
+      {
+         rule += (child > 0) ? ", " : "";
+         rule += std::to_string(1 + generator() % 3) + " shade " + std::to_string(generator() % bag_count) + " bags";
+      }
+      rules.push_back(rule + ((children > 0) ? "." : ""));
+   }
+   return rules;
+}
+
+/**
+ * @brief check the batched sets and counts against one breadth first search per bag
+ * @param graph the graph
+*/
+static void expect_batched_counts_match_single_queries(const BagGraph& graph)
+{
+   ContainerQuery query{ graph };
+   std::vector<uint32_t> bags(graph.size());
+   std::iota(bags.begin(), bags.end(), 0);
+   auto containers = query.containers_of(bags);
+   auto counts = query.count_containers(bags);
+   ASSERT_EQ(bags.size(), containers.size());
+   ASSERT_EQ(bags.size(), counts.size());
+   for (auto bag : bags)
+   {
+      const DenseBitset expected = query.containers_of(bag);
+      EXPECT_TRUE(expected == containers[bag]) << "bag " << graph.color_table().name(bag);
+      EXPECT_EQ(expected.count(), counts[bag]) << "bag " << graph.color_table().name(bag);
+   }
+}
+
+
+/**
+ * @test batched queries across several 64 query batches give the same sets as the single query search
+*/
+TEST(container_query_tests, test_batched_counts_match_single_queries)
+{
+   for (uint32_t seed : { 1u, 2u, 3u })
+   {
+      auto rules = random_rules(150, seed);
+      expect_batched_counts_match_single_queries(BagGraph::from_lines(rules));
+   }
+}
+
+/**
+ * @test bags in a containment cycle, or that contain themselves, count themselves as a container
+*/
+TEST(container_query_tests, test_batched_counts_with_cycles)
+{
+   std::vector<std::string> rules{
+      "light red bags contain 1 dark blue bag.",
+      "dark blue bags contain 2 pale green bags, 1 light red bag.",
+      "pale green bags contain no other bags.",
+      "shiny gold bags contain 1 shiny gold bag, 3 pale green bags.",
+      "dull tan bags contain 1 shiny gold bag.",
+   };
+   BagGraph graph = BagGraph::from_lines(rules);
+   ContainerQuery query{ graph };
+   auto id = [&graph](const char* name) { return *graph.color_table().find(name); };
+
+   const std::vector<uint32_t> bags{ id("light red"), id("dark blue"), id("pale green"), id("shiny gold"), id("dull tan") };
+   auto counts = query.count_containers(bags);
+   EXPECT_EQ(2u, counts[0]);    //!< itself and dark blue, through the cycle
+   EXPECT_EQ(2u, counts[1]);
+   EXPECT_EQ(4u, counts[2]);    //!< every other bag, dull tan through shiny gold
+   EXPECT_EQ(2u, counts[3]);    //!< itself and dull tan
+   EXPECT_EQ(0u, counts[4]);
+   expect_batched_counts_match_single_queries(graph);
+
+   /* the same bags queried in a batch that crosses the 64 query word boundary */
+   std::vector<uint32_t> repeated;
+   for (std::size_t i = 0; i < 130; i++)
+   {
+      repeated.push_back(bags[i % bags.size()]);
+   }
+   auto repeated_counts = query.count_containers(repeated);
+   auto repeated_sets = query.containers_of(repeated);
+   for (std::size_t i = 0; i < repeated.size(); i++)
+   {
+      EXPECT_EQ(counts[i % bags.size()], repeated_counts[i]);
+      EXPECT_TRUE(query.containers_of(repeated[i]) == repeated_sets[i]);
+   }
+
+   /* the containing sets themselves, not just their sizes */
+   auto sets = query.containers_of(bags);
+   EXPECT_TRUE(sets[3].test(id("shiny gold")));
+   EXPECT_TRUE(sets[3].test(id("dull tan")));
+   EXPECT_FALSE(sets[2].test(id("pale green")));
+}
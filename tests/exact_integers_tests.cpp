@@ -0,0 +1,77 @@
+/*! \file exact_integers_tests.cpp
+*
+*  \brief tests for the big integer and modular integer types
+*
+*
+*  \author Graham Riches
+*/
+
+/********************************** Includes *******************************************/
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "exact_integers.h"
+
+
+/**
+ * @test construction and printing, including limbs that need zero padding
+*/
+TEST( exact_integers_tests, test_big_unsigned_to_string )
+{
+   EXPECT_EQ( "0", BigUnsigned{}.to_string( ) );
+   EXPECT_EQ( "1000000007", BigUnsigned{ 1000000007 }.to_string( ) );
+   EXPECT_EQ( "18446744073709551615", BigUnsigned{ UINT64_MAX }.to_string( ) );
+
+   std::ostringstream stream;
+   stream << BigUnsigned{ 42 };
+   EXPECT_EQ( "42", stream.str( ) );
+}
+
+/**
+ * @test addition carries past 64 bits
+*/
+TEST( exact_integers_tests, test_big_unsigned_addition )
+{
+   BigUnsigned sum = BigUnsigned{ UINT64_MAX } + BigUnsigned{ 1 };
+   EXPECT_EQ( "18446744073709551616", sum.to_string( ) );
+
+   sum += BigUnsigned{ 12345678901234567890ULL };
+   EXPECT_EQ( "30792422974944119506", sum.to_string( ) );
+   EXPECT_EQ( sum, BigUnsigned{ 12345678901234567890ULL } + BigUnsigned{ UINT64_MAX } + BigUnsigned{ 1 } );
+}
+
+/**
+ * @test a long tribonacci run (the adapter chain recurrence) stays exact, and the modular version agrees with it
+*/
+TEST( exact_integers_tests, test_tribonacci_exact_and_modular )
+{
+   std::vector<BigUnsigned> exact{ 1 };
+   std::vector<Modular<1000000007>> modular{ 1 };
+   for ( std::size_t i = 1; i <= 200; i++ )
+   {
+      BigUnsigned next_exact;
+      Modular<1000000007> next_modular;
+      for ( std::size_t j = ( i > 3 ) ? i - 3 : 0; j < i; j++ )
+      {
+         next_exact += exact[j];
+         next_modular += modular[j];
+      }
+      exact.push_back( next_exact );
+      modular.push_back( next_modular );
+   }
+   EXPECT_EQ( "52622583840983769603765180599790256716084480555530641", exact.back( ).to_string( ) );
+   EXPECT_EQ( 615475309u, modular.back( ).value( ) );
+}
+
+/**
+ * @test modular multiplication of values whose product overflows 64 bits
+*/
+TEST( exact_integers_tests, test_modular_multiplication )
+{
+   Modular<1000000007> a{ 123456789012ULL };
+   Modular<1000000007> b{ 987654321098ULL };
+   EXPECT_EQ( 474193777u, ( a * b ).value( ) );
+   EXPECT_EQ( 145586007u, Modular<1000000007>{ ( uint64_t{ 1 } << 62 ) + 5 }.value( ) );
+}
@@ -0,0 +1,70 @@
+/*! \file k_sum_tests.cpp
+*
+*  \brief tests for the k-sum search functions
+*
+*
+*  \author Graham Riches
+*/
+
+/********************************** Includes *******************************************/
+#include <gtest/gtest.h>
+#include <numeric>
+#include <vector>
+#include "k_sum.h"
+
+
+/**
+ * @test finding a pair with the hashed two sum
+*/
+TEST( k_sum_tests, test_two_sum_returns_indices )
+{
+   std::vector<int> values{ 1721, 979, 366, 299, 675, 1456 };
+   auto match = two_sum( values, 2020 );
+   ASSERT_TRUE( match.has_value( ) );
+   EXPECT_EQ( ( std::vector<std::size_t>{ 0, 3 } ), *match );
+}
+
+/**
+ * @test that an entry can't be paired with itself
+*/
+TEST( k_sum_tests, test_two_sum_does_not_reuse_an_entry )
+{
+   std::vector<int> values{ 1010, 5, 7 };
+   EXPECT_FALSE( two_sum( values, 2020 ).has_value( ) );
+   values.push_back( 1010 );
+   EXPECT_EQ( ( std::vector<std::size_t>{ 0, 3 } ), *two_sum( values, 2020 ) );
+}
+
+/**
+ * @test finding a triplet with the sorted two pointer scan maps back to the original indices
+*/
+TEST( k_sum_tests, test_three_sum_returns_original_indices )
+{
+   std::vector<int> values{ 1721, 979, 366, 299, 675, 1456 };
+   auto match = three_sum( values, 2020 );
+   ASSERT_TRUE( match.has_value( ) );
+   EXPECT_EQ( ( std::vector<std::size_t>{ 1, 2, 4 } ), *match );
+}
+
+/**
+ * @test the generic recursion for larger k including negative values
+*/
+TEST( k_sum_tests, test_k_sum_with_negative_values )
+{
+   std::vector<long> values{ 40, -7, 13, 2, -30, 8, 100, 24 };
+   auto match = k_sum( values, 0L, 4 );
+   ASSERT_TRUE( match.has_value( ) );
+   auto sum = std::accumulate( match->cbegin( ), match->cend( ), 0L, [&values]( long total, std::size_t i ) { return total + values[i]; } );
+   EXPECT_EQ( ( std::vector<std::size_t>{ 1, 2, 4, 7 } ), *match );
+   EXPECT_EQ( 0, sum );
+}
+
+/**
+ * @test that no match returns nullopt
+*/
+TEST( k_sum_tests, test_k_sum_no_match )
+{
+   std::vector<int> values{ 1, 2, 3, 4 };
+   EXPECT_FALSE( k_sum( values, 100, 3 ).has_value( ) );
+   EXPECT_FALSE( k_sum( values, 10, 5 ).has_value( ) );
+}
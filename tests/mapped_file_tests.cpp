@@ -0,0 +1,114 @@
+/*! \file mapped_file_tests.cpp
+*
+*  \brief tests for the memory mapped file input
+*
+*
+*  \author Graham Riches
+*/
+
+/********************************** Includes *******************************************/
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "mapped_file.h"
+
+
+/**
+ * @brief test fixture that writes a small file to the temp directory
+*/
+class TestMappedFileSetup : public ::testing::Test
+{
+protected:
+   void SetUp() override
+   {
+      this->path = std::filesystem::temp_directory_path() / "mapped_file_tests.txt";
+      std::ofstream stream{ this->path, std::ios::binary };
+      stream << "first line\r\nsecond line\n\nfourth line\n";
+   }
+
+   void TearDown() override
+   {
+      std::filesystem::remove( this->path );
+   }
+
+public:
+   std::filesystem::path path;
+};
+
+
+/**
+ * @test that lines are iterated the same way std::getline would
+*/
+TEST_F( TestMappedFileSetup, test_reading_lines )
+{
+   MappedFile file{ this->path.string() };
+   ASSERT_TRUE( file.is_open() );
+
+   std::vector<std::string_view> lines;
+   for ( auto line : file.lines() )
+   {
+      lines.push_back( line );
+   }
+   ASSERT_EQ( 4, lines.size() );
+   EXPECT_EQ( "first line", lines[0] );
+   EXPECT_EQ( "second line", lines[1] );
+   EXPECT_EQ( "", lines[2] );
+   EXPECT_EQ( "fourth line", lines[3] );
+}
+
+/**
+ * @test that chunks are aligned to the delimiter and cover the whole file
+*/
+TEST_F( TestMappedFileSetup, test_chunks_are_record_aligned )
+{
+   MappedFile file{ this->path.string() };
+   auto chunks = file.chunks( 3 );
+   ASSERT_GT( chunks.size(), 1 );
+
+   std::string joined;
+   for ( auto chunk : chunks )
+   {
+      EXPECT_EQ( '\n', chunk.back() );
+      joined.append( chunk );
+   }
+   EXPECT_EQ( file.view(), joined );
+}
+
+/**
+ * @test that a mapping can be moved without unmapping it
+*/
+TEST_F( TestMappedFileSetup, test_move_constructor )
+{
+   MappedFile file{ this->path.string() };
+   auto size = file.size();
+   MappedFile moved{ std::move( file ) };
+   EXPECT_EQ( size, moved.size() );
+   EXPECT_EQ( 0, file.size() );
+   EXPECT_FALSE( file.is_open() );
+}
+
+/**
+ * @test that a missing file maps as empty
+*/
+TEST( mapped_file_tests, test_missing_file_is_empty )
+{
+   MappedFile file{ "this_file_does_not_exist.txt" };
+   EXPECT_FALSE( file.is_open() );
+   EXPECT_EQ( 0, file.size() );
+   EXPECT_TRUE( file.lines().begin() == file.lines().end() );
+}
+
+/**
+ * @test splitting a buffer into record aligned chunks on a multi character delimiter
+*/
+TEST( mapped_file_tests, test_split_into_chunks_by_blank_lines )
+{
+   std::string_view input{ "a b\nc\n\nd e\n\nf\ng" };
+   auto chunks = split_into_chunks( input, 8, "\n\n" );
+   ASSERT_EQ( 3, chunks.size() );
+   EXPECT_EQ( "a b\nc\n\n", chunks[0] );
+   EXPECT_EQ( "d e\n\n", chunks[1] );
+   EXPECT_EQ( "f\ng", chunks[2] );
+}
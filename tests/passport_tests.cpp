@@ -0,0 +1,130 @@
+/*! \file passport_tests.cpp
+*
+*  \brief tests for the day 4 passport field rules
+*
+*
+*  \author Graham Riches
+*/
+
+/********************************** Includes *******************************************/
+#include <gtest/gtest.h>
+#include <array>
+#include <string>
+#include <utility>
+#include "passport.h"
+
+
+/**
+ * @brief a passport that passes every rule, with one field replaced
+ * @param key the key to replace
+ * @param value the new value. Empty to drop the field
+ * @return the record
+*/
+static std::string passport_with(const std::string& key, const std::string& value)
+{
+   const std::array<std::pair<std::string, std::string>, 8> fields{ { {"pid", "087499704"}, {"hgt", "74in"}, {"ecl", "grn"}, {"iyr", "2012"},
+                                                                     {"eyr", "2030"}, {"byr", "1980"}, {"hcl", "#623a2f"}, {"cid", "88"} } };
+   std::string record;
+   for (const auto& [field_key, field_value] : fields)
+   {
+      const std::string& used = (field_key == key) ? value : field_value;
+      if (!used.empty())
+      {
+         record += field_key + ":" + used + "\n";
+      }
+   }
+   return record;
+}
+
+/**
+ * @brief check one field value against the full rule set
+ * @param key the field key
+ * @param value the value
+ * @return true if the passport is valid
+*/
+static bool is_valid_with(const std::string& key, const std::string& value)
+{
+   const std::string record = passport_with(key, value);
+   const Passport passport = Passport::from_string(record);
+   return passport.check_contains(required_passport_fields) && passport.validate_all_fields();
+}
+
+
+/**
+ * @test the year rules accept exactly four digits inside their ranges
+*/
+TEST(passport_tests, test_year_rules)
+{
+   EXPECT_TRUE(is_valid_with("byr", "1920"));
+   EXPECT_TRUE(is_valid_with("byr", "2002"));
+   EXPECT_FALSE(is_valid_with("byr", "2003"));
+   EXPECT_FALSE(is_valid_with("byr", "01980"));
+   EXPECT_TRUE(is_valid_with("iyr", "2010"));
+   EXPECT_FALSE(is_valid_with("iyr", "2021"));
+   EXPECT_TRUE(is_valid_with("eyr", "2020"));
+   EXPECT_FALSE(is_valid_with("eyr", "2031"));
+}
+
+/**
+ * @test the height needs a unit and is checked against that unit's range
+*/
+TEST(passport_tests, test_height_rule)
+{
+   EXPECT_TRUE(is_valid_with("hgt", "150cm"));
+   EXPECT_TRUE(is_valid_with("hgt", "193cm"));
+   EXPECT_FALSE(is_valid_with("hgt", "194cm"));
+   EXPECT_TRUE(is_valid_with("hgt", "59in"));
+   EXPECT_TRUE(is_valid_with("hgt", "76in"));
+   EXPECT_FALSE(is_valid_with("hgt", "77in"));
+   EXPECT_FALSE(is_valid_with("hgt", "190"));
+   EXPECT_FALSE(is_valid_with("hgt", "cm"));
+   EXPECT_FALSE(is_valid_with("hgt", "60cmx"));
+}
+
+/**
+ * @test the hair colour is '#' and six lower case hex digits
+*/
+TEST(passport_tests, test_hair_color_rule)
+{
+   EXPECT_TRUE(is_valid_with("hcl", "#123abc"));
+   EXPECT_FALSE(is_valid_with("hcl", "#123abz"));
+   EXPECT_FALSE(is_valid_with("hcl", "123abc"));
+   EXPECT_FALSE(is_valid_with("hcl", "#123ab"));
+   EXPECT_FALSE(is_valid_with("hcl", "#123ABC"));
+}
+
+/**
+ * @test the eye colour is one of the listed codes
+*/
+TEST(passport_tests, test_eye_color_rule)
+{
+   EXPECT_TRUE(is_valid_with("ecl", "brn"));
+   EXPECT_FALSE(is_valid_with("ecl", "wat"));
+   EXPECT_FALSE(is_valid_with("ecl", "brnn"));
+}
+
+/**
+ * @test the passport id is exactly nine digits
+*/
+TEST(passport_tests, test_id_rule)
+{
+   EXPECT_TRUE(is_valid_with("pid", "000000001"));
+   EXPECT_FALSE(is_valid_with("pid", "0123456789"));
+   EXPECT_FALSE(is_valid_with("pid", "12345678"));
+   EXPECT_FALSE(is_valid_with("pid", "12345678a"));
+}
+
+/**
+ * @test a missing required field fails both parts, a missing country id doesn't
+*/
+TEST(passport_tests, test_missing_fields)
+{
+   for (const std::string key : { "pid", "byr", "iyr", "eyr", "hgt", "hcl", "ecl" })
+   {
+      const std::string record = passport_with(key, "");
+      const Passport passport = Passport::from_string(record);
+      EXPECT_FALSE(passport.check_contains(required_passport_fields)) << key;
+      EXPECT_FALSE(passport.validate_all_fields()) << key;
+   }
+   EXPECT_TRUE(is_valid_with("cid", ""));
+}
@@ -0,0 +1,47 @@
+/*! \file password_batch_tests.cpp
+*
+*  \brief tests for the day 2 password batch letter counting
+*
+*
+*  \author Graham Riches
+*/
+
+/********************************** Includes *******************************************/
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "password_batch.h"
+
+
+/**
+ * @test the vector letter count agrees with a scalar count for every length and for buffers that end exactly
+ *       at a block boundary, just past one, or right at the end of the password. Every byte after the password
+ *       is the letter being counted, so any unmasked tail shows up in the count
+*/
+TEST(password_batch_tests, test_count_letter_matches_scalar_count)
+{
+   for (std::size_t length = 0; length <= 40; length++)
+   {
+      for (std::size_t block : { std::size_t{ 16 }, std::size_t{ 32 } })
+      {
+         const std::size_t boundary = (length + block - 1) / block * block;
+         for (std::size_t readable : { length, length + 1, boundary, boundary + 1 })
+         {
+            if (readable < length)
+            {
+               continue;
+            }
+            std::vector<char> buffer(readable + 1, 'a');
+            uint32_t expected{0};
+            for (std::size_t i = 0; i < length; i++)
+            {
+               buffer[i] = ((i * 7) % 3 == 0) ? 'a' : 'b';
+               expected += (buffer[i] == 'a');
+            }
+            EXPECT_EQ(expected, count_letter(buffer.data(), length, readable, 'a')) << "length " << length << ", readable " << readable;
+            EXPECT_EQ(length - expected, count_letter(buffer.data(), length, readable, 'b')) << "length " << length << ", readable " << readable;
+         }
+      }
+   }
+}
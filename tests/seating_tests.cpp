@@ -0,0 +1,315 @@
+/*! \file seating_tests.cpp
+*
+*  \brief tests for the day 11 seating simulations against a plain scalar reference
+*
+*
+*  \author Graham Riches
+*/
+
+/********************************** Includes *******************************************/
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "banded_step.h"
+#include "incremental.h"
+#include "neighbour_table.h"
+#include "seat_grid.h"
+#include "thread_pool.h"
+
+
+/************************************ Types ********************************************/
+using Layout = std::vector<std::string>;
+
+
+/****************************** Function Definitions ***********************************/
+/**
+ * @brief run one generation of the puzzle rules the obvious way
+ * @param layout the layout as lines of 'L', '#' and '.'
+ * @param line_of_sight true to look past floor to the first seat in each direction
+ * @param threshold number of occupied neighbours that empties an occupied seat
+ * @return the next generation
+*/
+static Layout reference_step(const Layout& layout, bool line_of_sight, int threshold)
+{
+   const int rows = static_cast<int>(layout.size());
+   const int columns = rows ? static_cast<int>(layout.front().size()) : 0;
+   Layout next = layout;
+   for (int row = 0; row < rows; row++)
+   {
+      for (int column = 0; column < columns; column++)
+      {
+         if (layout[row][column] == '.')
+         {
+            continue;
+         }
+         int count{0};
+         for (int dr = -1; dr <= 1; dr++)
+         {
+            for (int dc = -1; dc <= 1; dc++)
+            {
+               if ((dr == 0) && (dc == 0))
+               {
+                  continue;
+               }
+               int r = row + dr;
+               int c = column + dc;
+               while (line_of_sight && (r >= 0) && (r < rows) && (c >= 0) && (c < columns) && (layout[r][c] == '.'))
+               {
+                  r += dr;
+                  c += dc;
+               }
+               count += (r >= 0) && (r < rows) && (c >= 0) && (c < columns) && (layout[r][c] == '#');
+            }
+         }
+         if ((layout[row][column] == 'L') && (count == 0))
+         {
+            next[row][column] = '#';
+         }
+         else if ((layout[row][column] == '#') && (count >= threshold))
+         {
+            next[row][column] = 'L';
+         }
+      }
+   }
+   return next;
+}
+
+/**
+ * @brief run the reference until nothing changes
+ * @param layout the starting layout
+ * @param line_of_sight true for the line of sight rule
+ * @param threshold number of occupied neighbours that empties an occupied seat
+ * @return the stable layout
+*/
+static Layout reference_fixed_point(Layout layout, bool line_of_sight, int threshold)
+{
+   for (Layout next = reference_step(layout, line_of_sight, threshold); next != layout;
+        next = reference_step(layout, line_of_sight, threshold))
+   {
+      layout = next;
+   }
+   return layout;
+}
+
+/**
+ * @brief read the current generation of a grid back out as lines
+ * @param grid the grid
+ * @return the layout
+*/
+static Layout to_layout(const SeatGrid& grid)
+{
+   Layout layout(grid.rows(), std::string(grid.columns(), '.'));
+   for (std::size_t row = 0; row < grid.rows(); row++)
+   {
+      for (std::size_t column = 0; column < grid.columns(); column++)
+      {
+         const auto index = grid.index(row, column);
+         if (grid.is_seat(index))
+         {
+            layout[row][column] = grid.is_occupied(index) ? '#' : 'L';
+         }
+      }
+   }
+   return layout;
+}
+
+/**
+ * @brief build a random layout
+ * @param generator random source
+ * @param rows row count
+ * @param columns column count
+ * @return the layout, roughly a quarter floor with a mix of empty and occupied seats
+*/
+static Layout random_layout(std::mt19937& generator, std::size_t rows, std::size_t columns)
+{
+   static const char cells[] = { '.', 'L', 'L', '#' };
+   Layout layout(rows, std::string(columns, '.'));
+   for (auto& line : layout)
+   {
+      for (auto& cell : line)
+      {
+         cell = cells[generator() % 4];
+      }
+   }
+   return layout;
+}
+
+/**
+ * @brief the layouts to check every mode on: the sample, single rows and columns, grids narrower than one vector
+ *        block and random grids either side of the block boundaries
+ * @return the layouts
+*/
+static std::vector<Layout> test_layouts(void)
+{
+   std::vector<Layout> layouts{
+      { "L.LL.LL.LL", "LLLLLLL.LL", "L.L.L..L..", "LLLL.LL.LL", "L.LL.LL.LL",
+        "L.LLLLL.LL", "..L.L.....", "LLLLLLLLLL", "L.LLLLLL.L", "L.LLLLL.LL" },
+      { "L" },
+      { "#" },
+      /* with one row per band, a row here is stable for a generation and then changes because the row above (or in
+         the mirrored copy, below) changed, so a band step that skipped it would go wrong */
+      { "##L", "##L", "#.L", "LL.", "LLL", "..." },
+      { "...", "LLL", "LL.", "#.L", "##L", "##L" },
+   };
+   std::mt19937 generator{ 11 };
+   const std::size_t shapes[][2] = {
+      { 1, 1 }, { 1, 2 }, { 1, 15 }, { 1, 16 }, { 1, 17 }, { 1, 40 },
+      { 2, 1 }, { 15, 1 }, { 16, 1 }, { 40, 1 },
+      { 3, 5 }, { 7, 15 }, { 12, 9 },
+      { 16, 16 }, { 9, 17 }, { 20, 31 }, { 17, 32 }, { 25, 33 }, { 40, 50 },
+   };
+   for (const auto& shape : shapes)
+   {
+      layouts.push_back(random_layout(generator, shape[0], shape[1]));
+      layouts.push_back(random_layout(generator, shape[0], shape[1]));
+   }
+   return layouts;
+}
+
+/**
+ * @brief describe a layout for failure messages
+*/
+static std::string describe(const Layout& layout)
+{
+   std::string text = std::to_string(layout.size()) + "x" + std::to_string(layout.empty() ? 0 : layout.front().size()) + "\n";
+   for (const auto& line : layout)
+   {
+      text += line + "\n";
+   }
+   return text;
+}
+
+/**
+ * @brief step the line of sight rule over a band of rows through a neighbour table, as the parallel part two does
+*/
+static bool step_table_rows(SeatGrid& grid, const NeighbourTable& table, std::size_t first_row, std::size_t last_row,
+                            uint32_t threshold)
+{
+   bool changed{false};
+   for (std::size_t row = first_row; row < last_row; row++)
+   {
+      for (std::size_t column = 0; column < grid.columns(); column++)
+      {
+         const auto cell = grid.index(row, column);
+         const auto seat = table.seat(cell);
+         if (seat == NeighbourTable::no_seat)
+         {
+            continue;
+         }
+         const bool occupied = grid.is_occupied(cell);
+         const uint32_t count = table.occupied_neighbours(grid, seat);
+         const bool updated = occupied ? (count < threshold) : (count == 0);
+         grid.set_next(cell, updated);
+         changed |= (updated != occupied);
+      }
+   }
+   return changed;
+}
+
+
+/**
+ * @test the vectorised adjacent step, one generation and to the fixed point
+*/
+TEST(seating_tests, test_step_adjacent)
+{
+   for (const auto& layout : test_layouts())
+   {
+      SCOPED_TRACE(describe(layout));
+      auto grid = SeatGrid::from_lines(layout);
+      const Layout next = reference_step(layout, false, 4);
+      EXPECT_EQ(next != layout, grid.step_adjacent(4));
+      EXPECT_EQ(next, to_layout(grid));
+
+      while (grid.step_adjacent(4)) {}
+      EXPECT_EQ(reference_fixed_point(layout, false, 4), to_layout(grid));
+   }
+}
+
+/**
+ * @test the table step with the adjacent and line of sight tables, one generation and to the fixed point
+*/
+TEST(seating_tests, test_step_with_table)
+{
+   for (const auto& layout : test_layouts())
+   {
+      SCOPED_TRACE(describe(layout));
+      for (bool line_of_sight : { false, true })
+      {
+         const int threshold = line_of_sight ? 5 : 4;
+         auto grid = SeatGrid::from_lines(layout);
+         const auto table = line_of_sight ? NeighbourTable::line_of_sight(grid) : NeighbourTable::adjacent(grid);
+         EXPECT_EQ(grid.count_seats(), table.size());
+
+         const Layout next = reference_step(layout, line_of_sight, threshold);
+         EXPECT_EQ(next != layout, step_with_table(grid, table, threshold));
+         EXPECT_EQ(next, to_layout(grid));
+
+         while (step_with_table(grid, table, threshold)) {}
+         EXPECT_EQ(reference_fixed_point(layout, line_of_sight, threshold), to_layout(grid));
+      }
+   }
+}
+
+/**
+ * @test the incremental simulation, one generation and to the fixed point, with its running occupied count
+*/
+TEST(seating_tests, test_incremental_simulation)
+{
+   for (const auto& layout : test_layouts())
+   {
+      SCOPED_TRACE(describe(layout));
+      for (bool line_of_sight : { false, true })
+      {
+         const int threshold = line_of_sight ? 5 : 4;
+         auto grid = SeatGrid::from_lines(layout);
+         const auto table = line_of_sight ? NeighbourTable::line_of_sight(grid) : NeighbourTable::adjacent(grid);
+         IncrementalSimulation simulation{ grid, table, static_cast<uint32_t>(threshold) };
+
+         simulation.step();
+         EXPECT_EQ(reference_step(layout, line_of_sight, threshold), to_layout(grid));
+         EXPECT_EQ(grid.count_occupied(), simulation.occupied());
+
+         simulation.run();
+         EXPECT_TRUE(simulation.is_stable());
+         EXPECT_EQ(reference_fixed_point(layout, line_of_sight, threshold), to_layout(grid));
+         EXPECT_EQ(grid.count_occupied(), simulation.occupied());
+      }
+   }
+}
+
+/**
+ * @test the banded parallel step with both rules and several band counts, one generation and to the fixed point.
+ *       Running to the fixed point reuses the band flags, so stable bands are skipped on the way
+*/
+TEST(seating_tests, test_banded_step)
+{
+   ThreadPool pool{ 4 };
+   for (const auto& layout : test_layouts())
+   {
+      SCOPED_TRACE(describe(layout));
+      for (std::size_t band_count : { std::size_t{ 0 }, std::size_t{ 1 }, std::size_t{ 3 }, layout.size() })
+      {
+         auto grid = SeatGrid::from_lines(layout);
+         BandedStep bands;
+         auto adjacent_rows = [&grid](std::size_t first, std::size_t last) { return grid.step_adjacent_rows(first, last, 4); };
+         const Layout next = reference_step(layout, false, 4);
+         EXPECT_EQ(next != layout, bands.run(grid, pool, band_count, true, adjacent_rows));
+         EXPECT_EQ(next, to_layout(grid));
+         while (bands.run(grid, pool, band_count, true, adjacent_rows)) {}
+         EXPECT_EQ(reference_fixed_point(layout, false, 4), to_layout(grid));
+
+         grid = SeatGrid::from_lines(layout);
+         bands.reset();
+         const auto table = NeighbourTable::line_of_sight(grid);
+         auto table_rows = [&grid, &table](std::size_t first, std::size_t last) { return step_table_rows(grid, table, first, last, 5); };
+         const Layout next_in_sight = reference_step(layout, true, 5);
+         EXPECT_EQ(next_in_sight != layout, bands.run(grid, pool, band_count, false, table_rows));
+         EXPECT_EQ(next_in_sight, to_layout(grid));
+         while (bands.run(grid, pool, band_count, false, table_rows)) {}
+         EXPECT_EQ(reference_fixed_point(layout, true, 5), to_layout(grid));
+      }
+   }
+}
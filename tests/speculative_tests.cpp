@@ -0,0 +1,281 @@
+/*! \file speculative_tests.cpp
+*
+*  \brief tests for the day 8 interpreter, repair search and speculative patch search against a brute force reference
+*
+*
+*  \author Graham Riches
+*/
+
+/********************************** Includes *******************************************/
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+#include "bytecode.h"
+#include "repair.h"
+#include "speculative.h"
+
+
+/************************************ Types ********************************************/
+/**
+ * @brief result of the plain reference interpreter
+*/
+struct ReferenceRun
+{
+   bool terminated{false};
+   int64_t accumulator{0};
+   uint64_t steps{0};
+};
+
+
+/****************************** Function Definitions ***********************************/
+/**
+ * @brief run a decoded program the obvious way, with none of the interpreter's tricks
+ * @param opcodes the opcode of each instruction
+ * @param operands the operand of each instruction
+ * @return how the run ended
+*/
+static ReferenceRun reference_run(const std::vector<Instructions>& opcodes, const std::vector<int32_t>& operands)
+{
+   ReferenceRun run;
+   std::vector<bool> seen(opcodes.size(), false);
+   int64_t pc{0};
+   while ((pc >= 0) && (static_cast<std::size_t>(pc) < opcodes.size()) && !seen[pc])
+   {
+      seen[pc] = true;
+      run.steps++;
+      run.accumulator += (opcodes[pc] == Instructions::acc) ? operands[pc] : 0;
+      pc += (opcodes[pc] == Instructions::jmp) ? operands[pc] : 1;
+   }
+   run.terminated = (static_cast<std::size_t>(pc) == opcodes.size());
+   return run;
+}
+
+/**
+ * @brief flip every nop/jmp in turn and run the result
+ * @param program the program
+ * @return the reference run for each flip, indexed by instruction (nullopt for acc)
+*/
+static std::vector<std::optional<ReferenceRun>> brute_force_flips(const Program& program)
+{
+   std::vector<Instructions> opcodes;
+   std::vector<int32_t> operands;
+   for (std::size_t i = 0; i < program.size(); i++)
+   {
+      opcodes.push_back(Program::opcode(program[i]));
+      operands.push_back(Program::operand(program[i]));
+   }
+
+   std::vector<std::optional<ReferenceRun>> flips(program.size());
+   for (std::size_t i = 0; i < program.size(); i++)
+   {
+      if (opcodes[i] == Instructions::acc)
+      {
+         continue;
+      }
+      const Instructions original = opcodes[i];
+      opcodes[i] = (original == Instructions::jmp) ? Instructions::nop : Instructions::jmp;
+      flips[i] = reference_run(opcodes, operands);
+      opcodes[i] = original;
+   }
+   return flips;
+}
+
+/**
+ * @brief build a random program that mostly walks forwards and then jumps back into itself
+ * @param generator random source
+ * @param length number of instructions before the final backwards jump
+ * @return the program source
+*/
+static std::string random_program(std::mt19937& generator, int length)
+{
+   std::string source;
+   for (int i = 0; i < length; i++)
+   {
+      const auto kind = generator() % 10;
+      if (kind < 6)
+      {
+         source += "acc +" + std::to_string(generator() % 50) + "\n";
+      }
+      else if (kind < 8)
+      {
+         const int operand = static_cast<int>(generator() % 7) - 3;
+         source += std::string{ "nop " } + ((operand < 0) ? "" : "+") + std::to_string(operand) + "\n";
+      }
+      else
+      {
+         source += "jmp +" + std::to_string(1 + generator() % 3) + "\n";
+      }
+   }
+   return source + "jmp -" + std::to_string(length / 2) + "\n";
+}
+
+/**
+ * @brief check find_repair and run_speculative against flipping every instruction by brute force
+ * @param program the program
+ * @param pool pool for the speculative search
+*/
+static void expect_repairs_match_brute_force(const Program& program, ThreadPool& pool)
+{
+   const auto flips = brute_force_flips(program);
+   std::optional<std::size_t> lowest;
+   for (std::size_t i = 0; i < flips.size(); i++)
+   {
+      if (flips[i].has_value() && flips[i]->terminated)
+      {
+         lowest = i;
+         break;
+      }
+   }
+
+   /* the repair walks the original path, so it finds some terminating flip, not necessarily the lowest */
+   const auto repair = find_repair(program);
+   ASSERT_EQ(lowest.has_value(), repair.has_value());
+   if (repair.has_value())
+   {
+      ASSERT_TRUE(flips[repair->index].has_value() && flips[repair->index]->terminated);
+      EXPECT_EQ(flips[repair->index]->accumulator, repair->accumulator);
+   }
+
+   /* the speculative search reports the lowest numbered candidate, the same as trying them in order */
+   const auto candidates = single_swap_candidates(program);
+   const auto speculative = run_speculative(program, candidates, pool);
+   ASSERT_EQ(lowest.has_value(), speculative.has_value());
+   if (speculative.has_value())
+   {
+      const std::size_t index = candidates[speculative->candidate].front().index;
+      EXPECT_EQ(*lowest, index);
+      EXPECT_EQ(flips[index]->accumulator, speculative->run.accumulator);
+      EXPECT_EQ(flips[index]->steps, speculative->run.steps);
+   }
+}
+
+
+/**
+ * @test the puzzle's sample program is fixed by swapping instruction 7 and exits with 8 in the accumulator
+*/
+TEST(speculative_tests, test_sample_program)
+{
+   auto program = Program::parse("nop +0\nacc +1\njmp +4\nacc +3\njmp -3\nacc -99\nacc +1\njmp -4\nacc +6\n");
+   ASSERT_TRUE(program.has_value());
+
+   std::vector<uint64_t> visited(1, 0);
+   const RunResult looped = execute(*program, visited);
+   EXPECT_EQ(RunStatus::infinite_loop, looped.status);
+   EXPECT_EQ(5, looped.accumulator);
+
+   const auto repair = find_repair(*program);
+   ASSERT_TRUE(repair.has_value());
+   EXPECT_EQ(7u, repair->index);
+   EXPECT_EQ(8, repair->accumulator);
+
+   ThreadPool pool{ 4 };
+   expect_repairs_match_brute_force(*program, pool);
+}
+
+/**
+ * @test generated programs, several long enough that the speculative runs go through many step limited slices
+*/
+TEST(speculative_tests, test_generated_programs_match_brute_force)
+{
+   std::mt19937 generator{ 7 };
+   ThreadPool pool{ 4 };
+   for (int trial = 0; trial < 12; trial++)
+   {
+      const int length = (trial < 6) ? 20 + static_cast<int>(generator() % 80) : 9000 + static_cast<int>(generator() % 3000);
+      auto program = Program::parse(random_program(generator, length));
+      ASSERT_TRUE(program.has_value());
+      expect_repairs_match_brute_force(*program, pool);
+   }
+}
+
+/**
+ * @test a candidate with several patches runs the program with all of them applied, and a later patch to the same
+ *       instruction wins
+*/
+TEST(speculative_tests, test_candidate_with_several_patches)
+{
+   /* both self loops have to go before the program can exit */
+   auto program = Program::parse("acc +1\njmp +0\nacc +100\njmp +0\nacc +10\n");
+   ASSERT_TRUE(program.has_value());
+   const uint32_t nop = Program::encode(Instructions::nop, 0);
+   const std::vector<std::vector<Patch>> candidates{
+      { Patch{ 1, nop } },
+      { Patch{ 3, nop } },
+      { Patch{ 1, nop }, Patch{ 3, Program::encode(Instructions::jmp, 0) }, Patch{ 3, nop } },
+   };
+
+   ThreadPool pool{ 2 };
+   auto result = run_speculative(*program, candidates, pool);
+   ASSERT_TRUE(result.has_value());
+   EXPECT_EQ(2u, result->candidate);
+   EXPECT_EQ(111, result->run.accumulator);
+   EXPECT_EQ(5u, result->run.steps);
+}
+
+/**
+ * @test running in step limited slices gives the same result as one run, and resumes where the last slice stopped
+*/
+TEST(speculative_tests, test_step_limit_slices)
+{
+   std::mt19937 generator{ 3 };
+   auto program = Program::parse(random_program(generator, 5000));
+   ASSERT_TRUE(program.has_value());
+
+   std::vector<uint64_t> whole_visited((program->size() + 63) / 64, 0);
+   const RunResult whole = execute(*program, whole_visited);
+   ASSERT_GT(whole.steps, 1000u);
+
+   std::vector<uint64_t> visited((program->size() + 63) / 64, 0);
+   NullTracer tracer;
+   RunResult slice;
+   uint64_t steps{0};
+   int slices{0};
+   do
+   {
+      slice = execute(*program, visited, tracer, slice.last, slice.accumulator, 100);
+      EXPECT_LE(slice.steps, 100u);
+      steps += slice.steps;
+      slices++;
+   } while (slice.status == RunStatus::step_limit);
+
+   EXPECT_GT(slices, 10);
+   EXPECT_EQ(whole.status, slice.status);
+   EXPECT_EQ(whole.accumulator, slice.accumulator);
+   EXPECT_EQ(whole.steps, steps);
+   EXPECT_EQ(whole.last, slice.last);
+   EXPECT_EQ(whole_visited, visited);
+}
+
+/**
+ * @test clear_visited leaves no bits behind, so the same visited array can run the program (or a patched
+ *       overlay of it) again with the same result
+*/
+TEST(speculative_tests, test_reuse_after_clear_visited)
+{
+   std::mt19937 generator{ 11 };
+   auto program = Program::parse(random_program(generator, 2000));
+   ASSERT_TRUE(program.has_value());
+   std::vector<uint64_t> visited((program->size() + 63) / 64, 0);
+   const std::vector<uint64_t> clear = visited;
+
+   const RunResult first = execute(*program, visited);
+   clear_visited(*program, visited, 0, first.steps);
+   EXPECT_EQ(clear, visited);
+   const RunResult second = execute(*program, visited);
+   EXPECT_EQ(first.accumulator, second.accumulator);
+   EXPECT_EQ(first.steps, second.steps);
+   clear_visited(*program, visited, 0, second.steps);
+   EXPECT_EQ(clear, visited);
+
+   /* and through an overlay, which takes a different path */
+   const std::vector<Patch> patches{ Patch{ 0, Program::encode(Instructions::jmp, 2) } };
+   PatchedProgram overlay{ *program, patches };
+   NullTracer tracer;
+   const RunResult patched = execute(overlay, visited, tracer);
+   clear_visited(overlay, visited, 0, patched.steps);
+   EXPECT_EQ(clear, visited);
+}
@@ -53,4 +53,101 @@ TEST(string_utilities_tests, test_string_strip_whitespace)
    std::string test_string{"string with whitespace"};
    test_string = strip(test_string, " " );
    EXPECT_EQ("stringwithwhitespace", test_string);
-}
\ No newline at end of file
+}
+
+/**
+ * @test strip is a single pass, so text that only forms the substring once a match is removed is kept
+*/
+TEST(string_utilities_tests, test_string_strip_single_pass_overlap)
+{
+   std::string test_string{"aabb"};
+   EXPECT_EQ("ab", strip(test_string, "ab"));
+   std::string repeated{"xxxx"};
+   EXPECT_EQ("", strip(repeated, "xx"));
+   std::string overlapping{"aaa"};
+   EXPECT_EQ("a", strip(overlapping, "aa"));
+}
+
+/**
+ * @test that split no longer modifies the input string
+*/
+TEST(string_utilities_tests, test_string_split_does_not_modify_input)
+{
+   std::string test_string{"this,is,a,test,string"};
+   std::vector<std::string> output = split(test_string, ",");
+   EXPECT_EQ("this,is,a,test,string", test_string);
+   EXPECT_EQ("string", output.back());
+}
+
+/**
+ * @test that the lazy split range yields the same tokens as split including empty ones
+*/
+TEST(string_utilities_tests, test_split_range_tokens)
+{
+   std::string_view test_string{"a\n\nbb\n\n\n\nccc\n\n"};
+   std::vector<std::string_view> tokens;
+   for (auto token : split_range(test_string, "\n\n"))
+   {
+      tokens.push_back(token);
+   }
+   ASSERT_EQ(5, tokens.size());
+   EXPECT_EQ("a", tokens[0]);
+   EXPECT_EQ("bb", tokens[1]);
+   EXPECT_EQ("", tokens[2]);
+   EXPECT_EQ("ccc", tokens[3]);
+   EXPECT_EQ("", tokens[4]);
+}
+
+/**
+ * @test that the split range can be used with the standard range algorithms
+*/
+TEST(string_utilities_tests, test_split_range_is_a_forward_view)
+{
+   static_assert(std::ranges::forward_range<SplitRange>);
+   static_assert(std::ranges::view<SplitRange>);
+
+   auto tokens = split_range("1,22,333", ",");
+   auto count = std::ranges::count_if(tokens, [](std::string_view token){ return token.size() > 1; });
+   EXPECT_EQ(2, count);
+   EXPECT_EQ("333", *std::ranges::next(tokens.begin(), 2));
+}
+
+/**
+ * @test stripping a set of overlapping patterns in one pass with the longest pattern winning
+*/
+TEST(string_utilities_tests, test_pattern_stripper_prefers_longest_pattern)
+{
+   PatternStripper stripper{ {" bag", ".", " bags"} };
+   std::string output;
+   auto removed = stripper.strip("light red bags contain 1 bright white bag, 2 muted yellow bags.", output);
+   EXPECT_EQ("light red contain 1 bright white, 2 muted yellow", output);
+   EXPECT_EQ(15, removed);
+}
+
+/**
+ * @test that the output buffer is cleared and reused between calls
+*/
+TEST(string_utilities_tests, test_pattern_stripper_reuses_output_buffer)
+{
+   PatternStripper stripper{ {"ab", ""} };
+   std::string output{"stale contents"};
+   EXPECT_EQ(0, stripper.strip("xyz", output));
+   EXPECT_EQ("xyz", output);
+   EXPECT_EQ(4, stripper.strip("abab", output));
+   EXPECT_EQ("", output);
+}
+
+/**
+ * @test one pass means text that only forms a pattern once a match is removed is kept, and matches never overlap
+*/
+TEST(string_utilities_tests, test_pattern_stripper_single_pass_overlap)
+{
+   PatternStripper stripper{ {"ab", "ba"} };
+   std::string output;
+   EXPECT_EQ(2, stripper.strip("aabb", output));
+   EXPECT_EQ("ab", output);
+   EXPECT_EQ(2, stripper.strip("aba", output));
+   EXPECT_EQ("a", output);
+   EXPECT_EQ(4, stripper.strip("xabbay", output));
+   EXPECT_EQ("xy", output);
+}
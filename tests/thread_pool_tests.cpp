@@ -0,0 +1,81 @@
+/*! \file thread_pool_tests.cpp
+*
+*  \brief tests for the thread pool
+*
+*
+*  \author Graham Riches
+*/
+
+/********************************** Includes *******************************************/
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "thread_pool.h"
+
+
+/**
+ * @test submitted tasks hand their results back through futures
+*/
+TEST( thread_pool_tests, test_submit_returns_results )
+{
+   ThreadPool pool{ 4 };
+   std::vector<std::future<int>> results;
+   for ( int i = 0; i < 100; i++ )
+   {
+      results.push_back( pool.submit( [i]( ) { return i * i; } ) );
+   }
+   for ( int i = 0; i < 100; i++ )
+   {
+      EXPECT_EQ( i * i, results[i].get( ) );
+   }
+}
+
+/**
+ * @test an exception thrown by a task is rethrown from its future
+*/
+TEST( thread_pool_tests, test_submit_forwards_exceptions )
+{
+   ThreadPool pool{ 2 };
+   auto result = pool.submit( []( ) -> int { throw std::runtime_error( "task failed" ); } );
+   EXPECT_THROW( result.get( ), std::runtime_error );
+}
+
+/**
+ * @test parallel_for visits every index exactly once, including counts smaller than the pool
+*/
+TEST( thread_pool_tests, test_parallel_for_visits_every_index )
+{
+   ThreadPool pool{ 3 };
+   for ( std::size_t count : { std::size_t{ 0 }, std::size_t{ 2 }, std::size_t{ 1000 } } )
+   {
+      std::vector<std::atomic<int>> visits( count );
+      pool.parallel_for( count, [&visits]( std::size_t i ) { visits[i]++; } );
+      for ( auto &visit : visits )
+      {
+         EXPECT_EQ( 1, visit.load( ) );
+      }
+   }
+}
+
+/**
+ * @test an exception from one block is only rethrown once every other block has finished with the callable
+*/
+TEST( thread_pool_tests, test_parallel_for_waits_for_every_block_before_rethrowing )
+{
+   ThreadPool pool{ 4 };
+   std::atomic<int> finished{ 0 };
+   auto body = [&finished]( std::size_t i ) {
+      if ( i == 0 )
+      {
+         throw std::runtime_error( "block failed" );
+      }
+      std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+      finished++;
+   };
+   EXPECT_THROW( pool.parallel_for( 40, body ), std::runtime_error );
+   EXPECT_EQ( 30, finished.load( ) );
+}
@@ -0,0 +1,139 @@
+/*! \file tracer_tests.cpp
+*
+*  \brief tests for the day 8 profiling tracer
+*
+*
+*  \author Graham Riches
+*/
+
+/********************************** Includes *******************************************/
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <vector>
+#include "bytecode.h"
+#include "tracer.h"
+
+
+/****************************** Function Definitions ***********************************/
+/**
+ * @brief the puzzle's sample program, which runs 0 1 2 6 7 3 4 and then loops back to 1
+*/
+static Program sample_program(void)
+{
+   return *Program::parse("nop +0\nacc +1\njmp +4\nacc +3\njmp -3\nacc -99\nacc +1\njmp -4\nacc +6\n");
+}
+
+/**
+ * @brief read a trace file written by ProfilingTracer::dump
+ * @param path the file
+ * @return the entries, or an empty vector if the count doesn't match the file
+*/
+static std::vector<TraceEntry> read_trace(const std::filesystem::path& path)
+{
+   std::ifstream stream{ path, std::ios::binary };
+   uint64_t count{0};
+   stream.read(reinterpret_cast<char*>(&count), sizeof(count));
+   std::vector<TraceEntry> entries(count);
+   stream.read(reinterpret_cast<char*>(entries.data()), static_cast<std::streamsize>(count * sizeof(TraceEntry)));
+   if (!stream || (stream.peek() != std::ifstream::traits_type::eof()))
+   {
+      return {};
+   }
+   return entries;
+}
+
+
+/**
+ * @test each instruction's count and each jmp's taken count, summed over two runs
+*/
+TEST(tracer_tests, test_execution_and_jump_counts)
+{
+   const Program program = sample_program();
+   std::vector<uint64_t> visited(1, 0);
+   ProfilingTracer tracer;
+
+   for (int run = 0; run < 2; run++)
+   {
+      const RunResult result = execute(program, visited, tracer);
+      EXPECT_EQ(RunStatus::infinite_loop, result.status);
+      clear_visited(program, visited, 0, result.steps);
+   }
+
+   const std::vector<uint64_t> expected_counts{ 2, 2, 2, 2, 2, 0, 2, 2, 0 };
+   EXPECT_EQ(expected_counts, tracer.execution_counts);
+
+   const std::map<std::size_t, uint64_t> expected_jumps{ { 2, 2 }, { 4, 2 }, { 7, 2 } };
+   EXPECT_EQ(expected_jumps, tracer.jump_counts);
+}
+
+/**
+ * @test two jmps with the same offset are counted separately
+*/
+TEST(tracer_tests, test_jumps_with_the_same_offset)
+{
+   const Program program = *Program::parse("jmp +2\nacc +1\njmp +2\nacc +1\nacc +1\n");
+   std::vector<uint64_t> visited(1, 0);
+   ProfilingTracer tracer;
+   const RunResult result = execute(program, visited, tracer);
+   EXPECT_EQ(RunStatus::terminated, result.status);
+
+   const std::map<std::size_t, uint64_t> expected_jumps{ { 0, 1 }, { 2, 1 } };
+   EXPECT_EQ(expected_jumps, tracer.jump_counts);
+}
+
+/**
+ * @test the dump holds the whole run, oldest first, with the accumulator before each instruction
+*/
+TEST(tracer_tests, test_dump_whole_run)
+{
+   const Program program = sample_program();
+   std::vector<uint64_t> visited(1, 0);
+   ProfilingTracer tracer{ 16 };
+   execute(program, visited, tracer);
+   ASSERT_EQ(7u, tracer.trace_size());
+
+   const auto path = std::filesystem::temp_directory_path() / "tracer_tests_whole.bin";
+   ASSERT_TRUE(tracer.dump(path.string()));
+   const auto entries = read_trace(path);
+   std::filesystem::remove(path);
+   ASSERT_EQ(7u, entries.size());
+
+   const std::vector<uint32_t> pcs{ 0, 1, 2, 6, 7, 3, 4 };
+   const std::vector<int64_t> accumulators{ 0, 0, 1, 1, 2, 2, 5 };
+   for (std::size_t i = 0; i < entries.size(); i++)
+   {
+      EXPECT_EQ(pcs[i], entries[i].pc);
+      EXPECT_EQ(program[pcs[i]], entries[i].word);
+      EXPECT_EQ(accumulators[i], entries[i].accumulator);
+   }
+}
+
+/**
+ * @test once the ring buffer wraps, the dump holds only the newest entries, still oldest first
+*/
+TEST(tracer_tests, test_dump_after_wrap)
+{
+   const Program program = sample_program();
+   std::vector<uint64_t> visited(1, 0);
+   ProfilingTracer tracer{ 3 };
+   execute(program, visited, tracer);
+   ASSERT_EQ(4u, tracer.trace_size());
+
+   const auto path = std::filesystem::temp_directory_path() / "tracer_tests_wrap.bin";
+   ASSERT_TRUE(tracer.dump(path.string()));
+   const auto entries = read_trace(path);
+   std::filesystem::remove(path);
+   ASSERT_EQ(4u, entries.size());
+
+   const std::vector<uint32_t> pcs{ 6, 7, 3, 4 };
+   const std::vector<int64_t> accumulators{ 1, 2, 2, 5 };
+   for (std::size_t i = 0; i < entries.size(); i++)
+   {
+      EXPECT_EQ(pcs[i], entries[i].pc);
+      EXPECT_EQ(program[pcs[i]], entries[i].word);
+      EXPECT_EQ(accumulators[i], entries[i].accumulator);
+   }
+}
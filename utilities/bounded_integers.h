@@ -0,0 +1,257 @@
+/*! \file bounded_integers.h
+*
+*  \brief tools for collections of small non-negative integers with a known upper bound. These
+*         replace a full sort when only the order, the gaps or the spacing of the values matter
+*
+*
+*  \author Graham Riches
+*/
+
+#pragma once
+
+/********************************** Includes *******************************************/
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+
+/*********************************** Consts ********************************************/
+constexpr uint64_t counting_sort_range_factor = 8;    //!< count table slots allowed per value before counting_sort falls back to std::sort
+constexpr uint64_t counting_sort_min_range = 1024;    //!< count table slots always allowed, so small inputs are always counted
+
+
+/************************************ Types ********************************************/
+/**
+ * @brief fixed size set of integers in [0, size) stored as packed 64 bit words
+ * @details every query walks whole words and jumps between set bits with count trailing zeros, so the cost
+ *          is O(size / 64 + number of values) no matter how the values were inserted
+*/
+class DenseBitset {
+  public:
+    /**
+     * @brief create an empty set
+     * @param range one past the largest value the set can hold
+    */
+    explicit DenseBitset( std::size_t range = 0 )
+        : range( range )
+        , words( ( range + 63 ) / 64, 0 ) { }
+
+    /**
+     * @brief build a set sized to fit a collection of values
+     * @tparam Range range of non-negative integers
+     * @param values the values. Duplicates are only stored once
+     * @return the new set
+     * @throws std::out_of_range if any value is negative
+    */
+    template <typename Range>
+    static DenseBitset from_values( const Range &values ) {
+        std::size_t range = 0;
+        for ( auto value : values ) {
+            if constexpr ( std::is_signed_v<decltype( value )> ) {
+                if ( value < 0 ) {
+                    throw std::out_of_range( "DenseBitset values must be non-negative" );
+                }
+            }
+            range = std::max( range, static_cast<std::size_t>( value ) + 1 );
+        }
+        DenseBitset set{ range };
+        for ( auto value : values ) {
+            set.set( static_cast<std::size_t>( value ) );
+        }
+        return set;
+    }
+
+    /**
+     * @brief get the number of values the set can hold
+     * @return one past the largest possible value
+    */
+    std::size_t size( void ) const {
+        return this->range;
+    }
+
+    /* the single value accessors only check the value is below size( ) in debug builds */
+
+    void set( std::size_t value ) {
+        assert( value < this->range );
+        this->words[value >> 6] |= uint64_t{ 1 } << ( value & 63 );
+    }
+
+    void reset( std::size_t value ) {
+        assert( value < this->range );
+        this->words[value >> 6] &= ~( uint64_t{ 1 } << ( value & 63 ) );
+    }
+
+    bool test( std::size_t value ) const {
+        assert( value < this->range );
+        return ( this->words[value >> 6] >> ( value & 63 ) ) & 1;
+    }
+
+    /**
+     * @brief count the values in the set
+     * @return the count
+    */
+    std::size_t count( void ) const {
+        std::size_t total = 0;
+        for ( auto word : this->words ) {
+            total += static_cast<std::size_t>( std::popcount( word ) );
+        }
+        return total;
+    }
+
+    /**
+     * @brief find the smallest value in the set that is at least some value
+     * @param from the value to start looking at
+     * @return the value, or nullopt if there isn't one
+    */
+    std::optional<std::size_t> next( std::size_t from ) const {
+        if ( from >= this->range ) {
+            return std::nullopt;
+        }
+        std::size_t index = from >> 6;
+        uint64_t word = this->words[index] & ( ~uint64_t{ 0 } << ( from & 63 ) );
+        while ( word == 0 ) {
+            if ( ++index == this->words.size( ) ) {
+                return std::nullopt;
+            }
+            word = this->words[index];
+        }
+        return ( index << 6 ) + static_cast<std::size_t>( std::countr_zero( word ) );
+    }
+
+    /**
+     * @brief get the smallest value in the set
+     * @return the value, or nullopt if the set is empty
+    */
+    std::optional<std::size_t> first( void ) const {
+        return this->next( 0 );
+    }
+
+    /**
+     * @brief get the largest value in the set
+     * @return the value, or nullopt if the set is empty
+    */
+    std::optional<std::size_t> last( void ) const {
+        for ( std::size_t index = this->words.size( ); index > 0; index-- ) {
+            if ( this->words[index - 1] != 0 ) {
+                return ( ( index - 1 ) << 6 ) + 63 - static_cast<std::size_t>( std::countl_zero( this->words[index - 1] ) );
+            }
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * @brief call a function on every value in the set in ascending order
+     * @tparam Callable void(std::size_t)
+     * @param callable the function to call
+    */
+    template <typename Callable>
+    void for_each( Callable &&callable ) const {
+        for ( std::size_t index = 0; index < this->words.size( ); index++ ) {
+            for ( uint64_t word = this->words[index]; word != 0; word &= word - 1 ) {
+                callable( ( index << 6 ) + static_cast<std::size_t>( std::countr_zero( word ) ) );
+            }
+        }
+    }
+
+    /**
+     * @brief find every value missing from the set whose two neighbours are both present
+     * @details each word is compared against itself shifted one place each way (carrying the edge bits in from
+     *          the neighbouring words) so a whole word of candidates is worked out at once
+     * @return the missing values in ascending order
+    */
+    std::vector<std::size_t> isolated_gaps( void ) const {
+        std::vector<std::size_t> gaps;
+        const std::size_t word_count = this->words.size( );
+        for ( std::size_t index = 0; index < word_count; index++ ) {
+            const uint64_t word = this->words[index];
+            const uint64_t below = ( word << 1 ) | ( ( index > 0 ) ? ( this->words[index - 1] >> 63 ) : 0 );
+            const uint64_t above = ( word >> 1 ) | ( ( index + 1 < word_count ) ? ( this->words[index + 1] << 63 ) : 0 );
+            for ( uint64_t missing = ~word & below & above; missing != 0; missing &= missing - 1 ) {
+                gaps.push_back( ( index << 6 ) + static_cast<std::size_t>( std::countr_zero( missing ) ) );
+            }
+        }
+        return gaps;
+    }
+
+    /**
+     * @brief count the spacing between consecutive values in the set
+     * @return histogram where entry d is the number of consecutive values that are d apart
+    */
+    std::vector<std::size_t> delta_histogram( void ) const {
+        std::vector<std::size_t> histogram;
+        std::optional<std::size_t> previous;
+        this->for_each( [&histogram, &previous]( std::size_t value ) {
+            if ( previous.has_value( ) ) {
+                const std::size_t delta = value - *previous;
+                if ( delta >= histogram.size( ) ) {
+                    histogram.resize( delta + 1, 0 );
+                }
+                histogram[delta]++;
+            }
+            previous = value;
+        } );
+        return histogram;
+    }
+
+    friend bool operator==( const DenseBitset &a, const DenseBitset &b ) {
+        return ( a.range == b.range ) && ( a.words == b.words );
+    }
+
+  private:
+    std::size_t range{ 0 };
+    std::vector<uint64_t> words;
+};
+
+
+/****************************** Function Definitions ***********************************/
+/**
+ * @brief sort integers in a known range by counting them. O(n + range)
+ * @details the range is worked out in the unsigned type so any [min, max] of T is representable. When the range
+ *          is much wider than the number of values the count table would cost more than it saves, so this falls
+ *          back to std::sort instead
+ * @tparam T integer type
+ * @param values the values to sort in place. Must all be in [min, max]
+ * @param min the smallest possible value
+ * @param max the largest possible value
+*/
+template <typename T>
+void counting_sort( std::vector<T> &values, T min, T max ) {
+    using Unsigned = std::make_unsigned_t<T>;
+    if ( values.empty( ) || ( max < min ) ) {
+        return;
+    }
+    const uint64_t span = static_cast<uint64_t>( static_cast<Unsigned>( static_cast<Unsigned>( max ) - static_cast<Unsigned>( min ) ) );
+    if ( span >= counting_sort_range_factor * static_cast<uint64_t>( values.size( ) ) + counting_sort_min_range ) {
+        std::sort( values.begin( ), values.end( ) );
+        return;
+    }
+    std::vector<std::size_t> counts( static_cast<std::size_t>( span ) + 1, 0 );
+    for ( auto value : values ) {
+        assert( ( value >= min ) && ( value <= max ) );
+        counts[static_cast<std::size_t>( static_cast<Unsigned>( static_cast<Unsigned>( value ) - static_cast<Unsigned>( min ) ) )]++;
+    }
+    auto output = values.begin( );
+    for ( std::size_t offset = 0; offset < counts.size( ); offset++ ) {
+        output = std::fill_n( output, counts[offset], static_cast<T>( static_cast<Unsigned>( static_cast<Unsigned>( min ) + static_cast<Unsigned>( offset ) ) ) );
+    }
+}
+
+/**
+ * @brief sort integers by counting them, taking the range from the values themselves
+ * @tparam T integer type
+ * @param values the values to sort in place
+*/
+template <typename T>
+void counting_sort( std::vector<T> &values ) {
+    if ( values.empty( ) ) {
+        return;
+    }
+    auto [min, max] = std::minmax_element( values.cbegin( ), values.cend( ) );
+    counting_sort( values, *min, *max );
+}
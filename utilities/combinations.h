@@ -8,6 +8,12 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <thread>
 #include <vector>
 
 /**
@@ -19,7 +25,7 @@
  * @return vector of pairs
 */
 template <typename T>
-std::vector<std::pair<T, T>> get_pair_combinations( std::vector<T> elements ) {
+std::vector<std::pair<T, T>> get_pair_combinations( const std::vector<T> &elements ) {
     std::vector<std::pair<T, T>> pairs;
     for ( int i = 0; i < elements.size( ); i++ ) {
         for ( int j = i + 1; j < elements.size( ); j++ ) {
@@ -38,7 +44,7 @@ std::vector<std::pair<T, T>> get_pair_combinations( std::vector<T> elements ) {
  * @return vector of pairs
 */
 template <typename T>
-std::vector<std::vector<T>> get_triplet_combinations( std::vector<T> elements ) {
+std::vector<std::vector<T>> get_triplet_combinations( const std::vector<T> &elements ) {
     std::vector<std::vector<T>> triplets;
     for ( int i = 0; i < elements.size( ); i++ ) {
         for ( int j = i + 1; j < elements.size( ); j++ ) {
@@ -48,4 +54,195 @@ std::vector<std::vector<T>> get_triplet_combinations( std::vector<T> elements )
         }
     }
     return triplets;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief step a set of sorted indices to the next k-combination in lexicographic order
+ * @param indices the current indices. Positions before first_free are held fixed
+ * @param size number of elements being chosen from
+ * @param first_free the first index position that is allowed to change
+ * @return the lowest position that changed, or indices.size( ) once every combination has been visited
+*/
+inline std::size_t next_combination( std::vector<std::size_t> &indices, std::size_t size, std::size_t first_free = 0 ) {
+    const std::size_t k = indices.size( );
+    std::size_t position = k;
+    while ( position > first_free ) {
+        position--;
+        if ( indices[position] != size - k + position ) {
+            indices[position]++;
+            for ( std::size_t j = position + 1; j < k; j++ ) {
+                indices[j] = indices[j - 1] + 1;
+            }
+            return position;
+        }
+    }
+    return k;
+}
+
+/**
+ * @brief lazy range of every k element combination of a vector
+ * @details combinations are generated one at a time in lexicographic index order, so nothing is
+ *          materialised up front and algorithms like std::ranges::find_if stop generating as soon as they
+ *          find a match. Each combination is handed out as a const reference to a vector of k values
+ *          that is updated in place as the iterator advances.
+ * @tparam T the element type
+*/
+template <typename T>
+class CombinationRange : public std::ranges::view_interface<CombinationRange<T>> {
+  public:
+    class Iterator {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::vector<T>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::vector<T> *;
+        using reference = const std::vector<T> &;
+
+        Iterator( void ){ };
+
+        Iterator( const std::vector<T> &elements, std::size_t k )
+            : elements( &elements )
+            , indices( k )
+            , values( k ) {
+            this->done = ( k == 0 ) || ( k > elements.size( ) );
+            for ( std::size_t i = 0; !this->done && ( i < k ); i++ ) {
+                this->indices[i] = i;
+                this->values[i] = elements[i];
+            }
+        }
+
+        reference operator*( ) const {
+            return this->values;
+        }
+
+        pointer operator->( ) const {
+            return &this->values;
+        }
+
+        Iterator &operator++( ) {
+            auto changed = next_combination( this->indices, this->elements->size( ) );
+            this->done = ( changed == this->indices.size( ) );
+            for ( std::size_t i = changed; i < this->indices.size( ); i++ ) {
+                this->values[i] = ( *this->elements )[this->indices[i]];
+            }
+            return *this;
+        }
+
+        Iterator operator++( int ) {
+            Iterator previous = *this;
+            ++( *this );
+            return previous;
+        }
+
+        /**
+         * @brief get the positions of the current combination in the source vector
+         * @return vector of k indices
+        */
+        const std::vector<std::size_t> &positions( void ) const {
+            return this->indices;
+        }
+
+        friend bool operator==( const Iterator &a, const Iterator &b ) {
+            return ( a.done == b.done ) && ( a.done || ( a.indices == b.indices ) );
+        }
+
+      private:
+        const std::vector<T> *elements{ nullptr };
+        std::vector<std::size_t> indices;
+        std::vector<T> values;
+        bool done{ true };
+    };
+
+    CombinationRange( void ){ };
+
+    /**
+     * @brief create a range of combinations
+     * @param elements the elements to choose from. Must outlive the range
+     * @param k how many elements per combination
+    */
+    CombinationRange( const std::vector<T> &elements, std::size_t k )
+        : elements( &elements )
+        , k( k ){ };
+
+    Iterator begin( void ) const {
+        return Iterator{ *this->elements, this->k };
+    }
+
+    Iterator end( void ) const {
+        return Iterator{ };
+    }
+
+  private:
+    const std::vector<T> *elements{ nullptr };
+    std::size_t k{ 0 };
+};
+
+/**
+ * @brief get a lazy range of every k element combination of a vector
+ * @tparam T the element type
+ * @param elements the elements to choose from
+ * @param k elements per combination
+ * @return the combination range
+*/
+template <typename T>
+CombinationRange<T> combinations( const std::vector<T> &elements, std::size_t k ) {
+    return CombinationRange<T>{ elements, k };
+}
+
+/**
+ * @brief call a function on every k element combination of a vector using multiple threads
+ * @details the index space is split on the first element of each combination. Workers pull the next
+ *          first index from a shared counter so the much larger blocks at the start of the list don't
+ *          all land on the same thread.
+ * @tparam T the element type
+ * @tparam Callable bool(const std::vector<T>&). Must be safe to call from several threads at once
+ * @param elements the elements to choose from
+ * @param k elements per combination
+ * @param callable function to call. Returning true stops every worker as soon as possible
+ * @param thread_count number of worker threads
+ * @return true if a call returned true and the search stopped early
+*/
+template <typename T, typename Callable>
+bool for_each_combination( const std::vector<T> &elements, std::size_t k, Callable callable, std::size_t thread_count = std::thread::hardware_concurrency( ) ) {
+    const std::size_t size = elements.size( );
+    if ( ( k == 0 ) || ( k > size ) ) {
+        return false;
+    }
+
+    std::atomic<std::size_t> next_first{ 0 };
+    std::atomic<bool> stop{ false };
+    auto worker = [&]( ) {
+        std::vector<std::size_t> indices( k );
+        std::vector<T> values( k );
+        for ( auto first = next_first++; ( first <= size - k ) && !stop.load( std::memory_order_relaxed ); first = next_first++ ) {
+            for ( std::size_t i = 0; i < k; i++ ) {
+                indices[i] = first + i;
+                values[i] = elements[first + i];
+            }
+            std::size_t changed = 0;
+            while ( changed < k ) {
+                if ( stop.load( std::memory_order_relaxed ) ) {
+                    return;
+                }
+                if ( callable( static_cast<const std::vector<T> &>( values ) ) ) {
+                    stop = true;
+                    return;
+                }
+                changed = next_combination( indices, size, 1 );
+                for ( std::size_t i = changed; i < k; i++ ) {
+                    values[i] = elements[indices[i]];
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for ( std::size_t i = 1; i < std::max<std::size_t>( thread_count, 1 ); i++ ) {
+        threads.emplace_back( worker );
+    }
+    worker( );
+    for ( auto &thread : threads ) {
+        thread.join( );
+    }
+    return stop;
+}
@@ -0,0 +1,158 @@
+/*! \file exact_integers.h
+*
+*  \brief integer types for counts that outgrow 64 bits: an arbitrary precision unsigned
+*         integer and an integer modulo a fixed constant
+*
+*
+*  \author Graham Riches
+*/
+
+#pragma once
+
+/********************************** Includes *******************************************/
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+/************************************ Types ********************************************/
+/**
+ * @brief arbitrary precision unsigned integer
+ * @details stored as little endian limbs in base 10^9 so that printing is just formatting each limb, which suits
+ *          counts that are mostly added up and then printed
+*/
+class BigUnsigned {
+  public:
+    BigUnsigned( uint64_t value = 0 ) {
+        while ( value > 0 ) {
+            this->limbs.push_back( static_cast<uint32_t>( value % base ) );
+            value /= base;
+        }
+    }
+
+    BigUnsigned &operator+=( const BigUnsigned &other ) {
+        if ( other.limbs.size( ) > this->limbs.size( ) ) {
+            this->limbs.resize( other.limbs.size( ), 0 );
+        }
+        uint32_t carry = 0;
+        for ( std::size_t i = 0; i < this->limbs.size( ); i++ ) {
+            uint32_t sum = this->limbs[i] + carry + ( ( i < other.limbs.size( ) ) ? other.limbs[i] : 0 );
+            carry = ( sum >= base ) ? 1 : 0;
+            this->limbs[i] = sum - carry * base;
+            if ( ( carry == 0 ) && ( i + 1 >= other.limbs.size( ) ) ) {
+                break;
+            }
+        }
+        if ( carry != 0 ) {
+            this->limbs.push_back( carry );
+        }
+        return *this;
+    }
+
+    friend BigUnsigned operator+( BigUnsigned a, const BigUnsigned &b ) {
+        a += b;
+        return a;
+    }
+
+    friend bool operator==( const BigUnsigned &a, const BigUnsigned &b ) {
+        return a.limbs == b.limbs;
+    }
+
+    /**
+     * @brief format the value in decimal
+     * @return the decimal string
+    */
+    std::string to_string( void ) const {
+        if ( this->limbs.empty( ) ) {
+            return "0";
+        }
+        std::string output = std::to_string( this->limbs.back( ) );
+        for ( std::size_t i = this->limbs.size( ) - 1; i > 0; i-- ) {
+            std::string limb = std::to_string( this->limbs[i - 1] );
+            output.append( base_digits - limb.size( ), '0' );
+            output += limb;
+        }
+        return output;
+    }
+
+    friend std::ostream &operator<<( std::ostream &os, const BigUnsigned &value ) {
+        os << value.to_string( );
+        return os;
+    }
+
+  private:
+    static constexpr uint32_t base = 1000000000;
+    static constexpr std::size_t base_digits = 9;
+    std::vector<uint32_t> limbs;    //!< least significant first, no leading zero limbs
+};
+
+
+/**
+ * @brief unsigned integer modulo a compile time constant
+ * @tparam Modulus the modulus. Must be at least 1 and below 2^63 so a sum of two residues can't overflow
+*/
+template <uint64_t Modulus>
+class Modular {
+    static_assert( ( Modulus >= 1 ) && ( Modulus < ( uint64_t{ 1 } << 63 ) ), "modulus must be in [1, 2^63)" );
+
+  public:
+    Modular( uint64_t value = 0 )
+        : residue( value % Modulus ) { }
+
+    uint64_t value( void ) const {
+        return this->residue;
+    }
+
+    Modular &operator+=( const Modular &other ) {
+        this->residue += other.residue;
+        if ( this->residue >= Modulus ) {
+            this->residue -= Modulus;
+        }
+        return *this;
+    }
+
+    Modular &operator*=( const Modular &other ) {
+#if defined( __SIZEOF_INT128__ )
+        this->residue = static_cast<uint64_t>( static_cast<unsigned __int128>( this->residue ) * other.residue % Modulus );
+#else
+        /* no 128 bit type (i.e. MSVC): shift and add, keeping every partial sum reduced */
+        uint64_t a = this->residue;
+        uint64_t b = other.residue;
+        uint64_t product = 0;
+        while ( b > 0 ) {
+            if ( b & 1 ) {
+                product = ( product + a ) % Modulus;
+            }
+            a = ( a << 1 ) % Modulus;
+            b >>= 1;
+        }
+        this->residue = product;
+#endif
+        return *this;
+    }
+
+    friend Modular operator+( Modular a, const Modular &b ) {
+        a += b;
+        return a;
+    }
+
+    friend Modular operator*( Modular a, const Modular &b ) {
+        a *= b;
+        return a;
+    }
+
+    friend bool operator==( const Modular &a, const Modular &b ) {
+        return a.residue == b.residue;
+    }
+
+    friend std::ostream &operator<<( std::ostream &os, const Modular &value ) {
+        os << value.residue;
+        return os;
+    }
+
+  private:
+    uint64_t residue{ 0 };
+};
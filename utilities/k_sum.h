@@ -0,0 +1,149 @@
+/*! \file k_sum.h
+*
+*  \brief find k entries in a list that add up to a target value without
+*         trying every combination
+*
+*
+*  \author Graham Riches
+*/
+
+#pragma once
+
+/********************************** Includes *******************************************/
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+
+/****************************** Function Definitions ***********************************/
+/**
+ * @brief find two entries that sum to a target using a hash of the values seen so far. O(n)
+ * @tparam T value type
+ * @param values list of values
+ * @param target the target sum
+ * @return the indices of the two entries in ascending order, or nullopt if there is no match
+*/
+template <typename T>
+std::optional<std::vector<std::size_t>> two_sum( const std::vector<T> &values, T target ) {
+    std::unordered_map<T, std::size_t> seen;
+    seen.reserve( values.size( ) );
+    for ( std::size_t i = 0; i < values.size( ); i++ ) {
+        auto complement = seen.find( target - values[i] );
+        if ( complement != seen.end( ) ) {
+            return std::vector<std::size_t>{ complement->second, i };
+        }
+        seen.emplace( values[i], i );
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief recursive k-sum over values that have already been sorted
+ * @details fixes one value per level and bottoms out in a two pointer scan. Each level skips
+ *          repeated values and prunes any start point where the smallest or largest possible
+ *          sum can't reach the target.
+ * @tparam T value type
+ * @param sorted the sorted values
+ * @param start first position that may be used at this level
+ * @param target the remaining target
+ * @param k how many values are still to be chosen (>= 2)
+ * @param chosen positions in the sorted list chosen so far. Filled in with the match on success
+ * @return true if a match was found
+*/
+template <typename T>
+bool sorted_k_sum( const std::vector<T> &sorted, std::size_t start, T target, std::size_t k, std::vector<std::size_t> &chosen ) {
+    if ( sorted.size( ) < start + k ) {
+        return false;
+    }
+
+    if ( k == 2 ) {
+        std::size_t low = start;
+        std::size_t high = sorted.size( ) - 1;
+        while ( low < high ) {
+            T sum = sorted[low] + sorted[high];
+            if ( sum == target ) {
+                chosen.push_back( low );
+                chosen.push_back( high );
+                return true;
+            }
+            ( sum < target ) ? low++ : high--;
+        }
+        return false;
+    }
+
+    /* the k - 1 largest values are fixed, so work them out once for the upper bound prune */
+    T largest_rest = std::accumulate( sorted.end( ) - ( k - 1 ), sorted.end( ), T{ 0 } );
+    for ( std::size_t i = start; i + k <= sorted.size( ); i++ ) {
+        if ( ( i > start ) && ( sorted[i] == sorted[i - 1] ) ) {
+            continue;
+        }
+        T smallest = std::accumulate( sorted.begin( ) + i, sorted.begin( ) + i + k, T{ 0 } );
+        if ( smallest > target ) {
+            break;
+        }
+        if ( sorted[i] + largest_rest < target ) {
+            continue;
+        }
+        chosen.push_back( i );
+        if ( sorted_k_sum( sorted, i + 1, target - sorted[i], k - 1, chosen ) ) {
+            return true;
+        }
+        chosen.pop_back( );
+    }
+    return false;
+}
+
+/**
+ * @brief find k entries that sum to a target
+ * @details k = 2 uses a single hashed pass. Anything larger sorts a copy of the values once and
+ *          uses the sorted two pointer scan, recursing one level per extra entry, so 3-sum is O(n^2)
+ *          and k-sum is O(n^(k-1)) at worst.
+ * @tparam T value type
+ * @param values list of values
+ * @param target the target sum
+ * @param k number of entries that must add up to the target
+ * @return the indices of the k entries in ascending order, or nullopt if there is no match
+*/
+template <typename T>
+std::optional<std::vector<std::size_t>> k_sum( const std::vector<T> &values, T target, std::size_t k ) {
+    if ( ( k == 0 ) || ( k > values.size( ) ) ) {
+        return std::nullopt;
+    }
+    if ( k == 1 ) {
+        auto match = std::find( values.cbegin( ), values.cend( ), target );
+        return ( match != values.cend( ) ) ? std::optional{ std::vector<std::size_t>{ static_cast<std::size_t>( match - values.cbegin( ) ) } } : std::nullopt;
+    }
+    if ( k == 2 ) {
+        return two_sum( values, target );
+    }
+
+    /* sort a permutation so the matching positions can be mapped back to the original list */
+    std::vector<std::size_t> order( values.size( ) );
+    std::iota( order.begin( ), order.end( ), 0 );
+    std::sort( order.begin( ), order.end( ), [&values]( std::size_t a, std::size_t b ) { return values[a] < values[b]; } );
+    std::vector<T> sorted( values.size( ) );
+    std::transform( order.cbegin( ), order.cend( ), sorted.begin( ), [&values]( std::size_t i ) { return values[i]; } );
+
+    std::vector<std::size_t> chosen;
+    if ( !sorted_k_sum( sorted, 0, target, k, chosen ) ) {
+        return std::nullopt;
+    }
+    std::transform( chosen.cbegin( ), chosen.cend( ), chosen.begin( ), [&order]( std::size_t i ) { return order[i]; } );
+    std::sort( chosen.begin( ), chosen.end( ) );
+    return chosen;
+}
+
+/**
+ * @brief find three entries that sum to a target with the sorted two pointer scan. O(n^2)
+ * @tparam T value type
+ * @param values list of values
+ * @param target the target sum
+ * @return the indices of the three entries in ascending order, or nullopt if there is no match
+*/
+template <typename T>
+std::optional<std::vector<std::size_t>> three_sum( const std::vector<T> &values, T target ) {
+    return k_sum( values, target, 3 );
+}
@@ -0,0 +1,351 @@
+/*! \file mapped_file.h
+*
+*  \brief read-only memory mapped view of an input file. Lines and chunks are handed out as
+*         string_views into the mapping so nothing is copied out of the page cache
+*
+*
+*  \author Graham Riches
+*/
+
+#pragma once
+
+/********************************** Includes *******************************************/
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined( _WIN32 )
+#    ifndef WIN32_LEAN_AND_MEAN
+#        define WIN32_LEAN_AND_MEAN
+#    endif
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+/****************************** Function Definitions ***********************************/
+/**
+ * @brief cut a buffer into roughly equal chunks that always end just after a delimiter
+ * @param input the buffer to chunk
+ * @param count the number of chunks to aim for
+ * @param delimiter record delimiter. Chunk boundaries are moved forward to the next one of these
+ * @return vector of at most count chunks covering the whole input
+ * @note useful for handing whole records to worker threads without splitting a record in two
+*/
+inline std::vector<std::string_view> split_into_chunks( std::string_view input, std::size_t count, std::string_view delimiter ) {
+    std::vector<std::string_view> chunks;
+    const std::size_t target_size = ( count > 1 ) ? input.size( ) / count : input.size( );
+    std::size_t start = 0;
+    for ( std::size_t i = 1; ( i < count ) && ( start < input.size( ) ); i++ ) {
+        auto boundary = input.find( delimiter, std::max( start + target_size, start + 1 ) );
+        if ( boundary == std::string_view::npos ) {
+            break;
+        }
+        boundary += delimiter.size( );
+        chunks.push_back( input.substr( start, boundary - start ) );
+        start = boundary;
+    }
+    if ( start < input.size( ) ) {
+        chunks.push_back( input.substr( start ) );
+    }
+    return chunks;
+}
+
+/************************************ Types ********************************************/
+/**
+ * @brief lazy range of the lines in a buffer. Behaves like std::getline: the trailing newline
+ *        does not produce an empty last line and a trailing carriage return is dropped
+*/
+class LineRange : public std::ranges::view_interface<LineRange> {
+  public:
+    class Iterator {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view *;
+        using reference = const std::string_view &;
+
+        Iterator( void ){ };
+
+        Iterator( const char *begin, const char *end )
+            : next( begin )
+            , end( end )
+            , done( false ) {
+            this->advance( );
+        }
+
+        reference operator*( ) const {
+            return this->line;
+        }
+
+        pointer operator->( ) const {
+            return &this->line;
+        }
+
+        Iterator &operator++( ) {
+            this->advance( );
+            return *this;
+        }
+
+        Iterator operator++( int ) {
+            Iterator previous = *this;
+            this->advance( );
+            return previous;
+        }
+
+        friend bool operator==( const Iterator &a, const Iterator &b ) {
+            return ( a.done == b.done ) && ( a.done || ( a.line.data( ) == b.line.data( ) ) );
+        }
+
+      private:
+        const char *next{ nullptr };
+        const char *end{ nullptr };
+        std::string_view line;
+        bool done{ true };
+
+        /**
+         * @brief step to the next line in the buffer
+        */
+        void advance( void ) {
+            if ( this->next == this->end ) {
+                this->done = true;
+                return;
+            }
+            auto length = static_cast<std::size_t>( this->end - this->next );
+            auto newline = static_cast<const char *>( std::memchr( this->next, '\n', length ) );
+            auto line_end = ( newline != nullptr ) ? newline : this->end;
+            this->line = std::string_view{ this->next, static_cast<std::size_t>( line_end - this->next ) };
+            if ( !this->line.empty( ) && ( this->line.back( ) == '\r' ) ) {
+                this->line.remove_suffix( 1 );
+            }
+            this->next = ( newline != nullptr ) ? newline + 1 : this->end;
+        }
+    };
+
+    LineRange( void ){ };
+
+    /**
+     * @brief create a line range over a buffer
+     * @param buffer the buffer to iterate. Must outlive the range
+    */
+    explicit LineRange( std::string_view buffer )
+        : buffer( buffer ){ };
+
+    Iterator begin( void ) const {
+        return Iterator{ this->buffer.data( ), this->buffer.data( ) + this->buffer.size( ) };
+    }
+
+    Iterator end( void ) const {
+        return Iterator{ };
+    }
+
+  private:
+    std::string_view buffer;
+};
+
+/**
+ * @brief read-only memory mapping of a whole file
+ * @note a file that can't be opened maps as empty, the same way a failed std::ifstream reads nothing
+*/
+class MappedFile {
+  public:
+    MappedFile( void ){ };
+
+    /**
+     * @brief map a file into memory
+     * @param filename path to the file
+    */
+    explicit MappedFile( const std::string &filename ) {
+        this->map( filename );
+    }
+
+    ~MappedFile( ) {
+        this->unmap( );
+    }
+
+    MappedFile( const MappedFile &file ) = delete;
+    MappedFile &operator=( const MappedFile &file ) = delete;
+
+    /**
+     * @brief move constructor takes ownership of the other mapping
+     * @param file the mapping to move from
+    */
+    MappedFile( MappedFile &&file ) noexcept {
+        this->take( file );
+    }
+
+    /**
+     * @brief move assignment releases the current mapping and takes ownership of the other one
+     * @param file the mapping to move from
+     * @return reference to self
+    */
+    MappedFile &operator=( MappedFile &&file ) noexcept {
+        if ( this != &file ) {
+            this->unmap( );
+            this->take( file );
+        }
+        return *this;
+    }
+
+    /**
+     * @brief check if the file was opened successfully
+     * @return true if the file opened, even if it is empty
+    */
+    bool is_open( void ) const {
+        return this->opened;
+    }
+
+    /**
+     * @brief get the size of the mapping in bytes
+     * @return size
+    */
+    std::size_t size( void ) const {
+        return this->length;
+    }
+
+    /**
+     * @brief view of the whole file
+     * @return string view into the mapping
+    */
+    std::string_view view( void ) const {
+        return std::string_view{ this->data, this->length };
+    }
+
+    /**
+     * @brief get a lazy range of every line in the file
+     * @return the line range. It is only valid while the mapping is alive
+    */
+    LineRange lines( void ) const {
+        return LineRange{ this->view( ) };
+    }
+
+    /**
+     * @brief cut the file into record aligned chunks
+     * @param count number of chunks to aim for
+     * @param delimiter the record delimiter
+     * @return vector of views into the mapping
+    */
+    std::vector<std::string_view> chunks( std::size_t count, std::string_view delimiter = "\n" ) const {
+        return split_into_chunks( this->view( ), count, delimiter );
+    }
+
+  private:
+    const char *data{ nullptr };
+    std::size_t length{ 0 };
+    bool opened{ false };
+#if defined( _WIN32 )
+    HANDLE file_handle{ INVALID_HANDLE_VALUE };
+    HANDLE mapping_handle{ nullptr };
+#endif
+
+    /**
+     * @brief open and map a file. Empty files are opened but not mapped as a zero length mapping is an error
+     * @param filename path to the file
+    */
+    void map( const std::string &filename ) {
+#if defined( _WIN32 )
+        this->file_handle = CreateFileA( filename.c_str( ), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr );
+        if ( this->file_handle == INVALID_HANDLE_VALUE ) {
+            return;
+        }
+        LARGE_INTEGER file_size;
+        if ( !GetFileSizeEx( this->file_handle, &file_size ) ) {
+            this->unmap( );
+            return;
+        }
+        this->opened = true;
+        if ( file_size.QuadPart == 0 ) {
+            return;
+        }
+        this->mapping_handle = CreateFileMappingA( this->file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr );
+        if ( this->mapping_handle == nullptr ) {
+            this->unmap( );
+            return;
+        }
+        auto address = MapViewOfFile( this->mapping_handle, FILE_MAP_READ, 0, 0, 0 );
+        if ( address == nullptr ) {
+            this->unmap( );
+            return;
+        }
+        this->data = static_cast<const char *>( address );
+        this->length = static_cast<std::size_t>( file_size.QuadPart );
+#else
+        int descriptor = ::open( filename.c_str( ), O_RDONLY );
+        if ( descriptor < 0 ) {
+            return;
+        }
+        struct stat file_status;
+        if ( ::fstat( descriptor, &file_status ) != 0 ) {
+            ::close( descriptor );
+            return;
+        }
+        this->opened = true;
+        if ( file_status.st_size > 0 ) {
+            auto length = static_cast<std::size_t>( file_status.st_size );
+            void *address = ::mmap( nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0 );
+            if ( address != MAP_FAILED ) {
+                ::madvise( address, length, MADV_SEQUENTIAL );
+                this->data = static_cast<const char *>( address );
+                this->length = length;
+            } else {
+                this->opened = false;
+            }
+        }
+        /* the mapping keeps its own reference to the file */
+        ::close( descriptor );
+#endif
+    }
+
+    /**
+     * @brief release the mapping and any handles
+    */
+    void unmap( void ) {
+#if defined( _WIN32 )
+        if ( this->data != nullptr ) {
+            UnmapViewOfFile( this->data );
+        }
+        if ( this->mapping_handle != nullptr ) {
+            CloseHandle( this->mapping_handle );
+        }
+        if ( this->file_handle != INVALID_HANDLE_VALUE ) {
+            CloseHandle( this->file_handle );
+        }
+        this->mapping_handle = nullptr;
+        this->file_handle = INVALID_HANDLE_VALUE;
+#else
+        if ( this->data != nullptr ) {
+            ::munmap( const_cast<char *>( this->data ), this->length );
+        }
+#endif
+        this->data = nullptr;
+        this->length = 0;
+        this->opened = false;
+    }
+
+    /**
+     * @brief steal the resources from another mapping and leave it empty
+     * @param file the mapping to take from
+    */
+    void take( MappedFile &file ) {
+        this->data = std::exchange( file.data, nullptr );
+        this->length = std::exchange( file.length, 0 );
+        this->opened = std::exchange( file.opened, false );
+#if defined( _WIN32 )
+        this->file_handle = std::exchange( file.file_handle, INVALID_HANDLE_VALUE );
+        this->mapping_handle = std::exchange( file.mapping_handle, nullptr );
+#endif
+    }
+};
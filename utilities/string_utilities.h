@@ -9,52 +9,216 @@
 #pragma once
 
 /********************************** Includes *******************************************/
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <ostream>
+#include <ranges>
 #include <regex>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
+#include "mapped_file.h"
+
+/************************************ Types ********************************************/
+/**
+ * @brief lazy range of the tokens between each delimiter in a string. Nothing is copied or modified,
+ *        and like split( ) a string with n delimiters always yields n + 1 tokens
+*/
+class SplitRange : public std::ranges::view_interface<SplitRange> {
+  public:
+    class Iterator {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view *;
+        using reference = const std::string_view &;
+
+        Iterator( void ){ };
+
+        Iterator( std::string_view input, std::string_view delimiter )
+            : remaining( input )
+            , delimiter( delimiter )
+            , done( false ) {
+            this->advance( );
+        }
+
+        reference operator*( ) const {
+            return this->token;
+        }
+
+        pointer operator->( ) const {
+            return &this->token;
+        }
+
+        Iterator &operator++( ) {
+            this->advance( );
+            return *this;
+        }
+
+        Iterator operator++( int ) {
+            Iterator previous = *this;
+            this->advance( );
+            return previous;
+        }
+
+        friend bool operator==( const Iterator &a, const Iterator &b ) {
+            return ( a.done == b.done ) && ( a.done || ( a.token.data( ) == b.token.data( ) ) );
+        }
+
+      private:
+        std::string_view remaining;
+        std::string_view delimiter;
+        std::string_view token;
+        bool last{ false };
+        bool done{ true };
+
+        /**
+         * @brief step to the next token
+        */
+        void advance( void ) {
+            if ( this->last ) {
+                this->done = true;
+                return;
+            }
+            auto position = this->delimiter.empty( ) ? std::string_view::npos : this->remaining.find( this->delimiter );
+            if ( position == std::string_view::npos ) {
+                this->token = this->remaining;
+                this->last = true;
+            } else {
+                this->token = this->remaining.substr( 0, position );
+                this->remaining.remove_prefix( position + this->delimiter.size( ) );
+            }
+        }
+    };
+
+    SplitRange( void ){ };
+
+    SplitRange( std::string_view input, std::string_view delimiter )
+        : input( input )
+        , delimiter( delimiter ){ };
+
+    Iterator begin( void ) const {
+        return Iterator{ this->input, this->delimiter };
+    }
+
+    Iterator end( void ) const {
+        return Iterator{ };
+    }
+
+  private:
+    std::string_view input;
+    std::string_view delimiter;
+};
+
+/**
+ * @brief removes every occurrence of a set of patterns from a string in one linear pass
+ * @details a 256 entry table of pattern first bytes lets the scan skip straight past any byte that can't
+ *          start a match. Where patterns overlap (i.e. " bags" and " bag") the longest one wins.
+*/
+class PatternStripper {
+  public:
+    /**
+     * @brief create a stripper for a set of patterns. Empty patterns are ignored
+     * @param patterns the patterns to remove
+    */
+    explicit PatternStripper( std::vector<std::string> patterns )
+        : patterns( std::move( patterns ) ) {
+        std::erase_if( this->patterns, []( const std::string &pattern ) { return pattern.empty( ); } );
+        std::stable_sort( this->patterns.begin( ), this->patterns.end( ), []( const std::string &a, const std::string &b ) { return a.size( ) > b.size( ); } );
+        for ( const auto &pattern : this->patterns ) {
+            this->first_bytes[static_cast<unsigned char>( pattern.front( ) )] = true;
+        }
+    }
+
+    /**
+     * @brief copy the input into an output buffer with every pattern removed
+     * @param input the input string
+     * @param output buffer to write to. It is cleared first so it can be reused between calls without reallocating
+     * @return number of bytes removed
+    */
+    std::size_t strip( std::string_view input, std::string &output ) const {
+        output.clear( );
+        std::size_t removed = 0;
+        std::size_t copied_up_to = 0;
+        std::size_t position = 0;
+        while ( position < input.size( ) ) {
+            if ( !this->first_bytes[static_cast<unsigned char>( input[position] )] ) {
+                position++;
+                continue;
+            }
+            auto match = std::find_if( this->patterns.cbegin( ), this->patterns.cend( ), [input, position]( const std::string &pattern ) {
+                return input.compare( position, pattern.size( ), pattern ) == 0;
+            } );
+            if ( match == this->patterns.cend( ) ) {
+                position++;
+                continue;
+            }
+            output.append( input.substr( copied_up_to, position - copied_up_to ) );
+            position += match->size( );
+            removed += match->size( );
+            copied_up_to = position;
+        }
+        output.append( input.substr( copied_up_to ) );
+        return removed;
+    }
+
+  private:
+    std::vector<std::string> patterns;
+    std::array<bool, 256> first_bytes{ };
+};
 
 /****************************** Function Definitions ***********************************/
 /**
- * @brief convert a filename to an open filestream
+ * @brief convert a filename to a memory mapped file
  * @param filename
- * @return
+ * @return the mapped file. Use .lines() to iterate it without copying
 */
-std::ifstream open_file( const std::string &filename ) {
-    return std::ifstream{ filename };
+MappedFile open_file( const std::string &filename ) {
+    return MappedFile{ filename };
 }
 
 /**
- * @brief read from an input stream into a vector of lines
- * @param stream
+ * @brief copy each line of a mapped file into a vector of lines
+ * @param file
  * @return
+ * @note compatibility wrapper for the older solutions: new code should iterate file.lines( ) directly
 */
-std::vector<std::string> read_file( std::ifstream &&stream ) {
+std::vector<std::string> read_file( const MappedFile &file ) {
     std::vector<std::string> data;
-    std::string line;
-    while ( std::getline( stream, line ) ) {
-        data.push_back( line );
+    for ( auto line : file.lines( ) ) {
+        data.emplace_back( line );
     }
     return data;
 }
 
+/**
+ * @brief lazily split a string into string_view tokens
+ * @param input the string to split. Must outlive the range
+ * @param delimiter substring delimiter
+ * @return range of tokens
+*/
+inline SplitRange split_range( std::string_view input, std::string_view delimiter ) {
+    return SplitRange{ input, delimiter };
+}
+
 /**
  * @brief split a string into a vector of strings
  * @param input the string to split
  * @param substring substring delimiter
  * @return 
 */
-std::vector<std::string> split( std::string &input, const std::string &delimiter ) {
+std::vector<std::string> split( std::string_view input, std::string_view delimiter ) {
     std::vector<std::string> list;
-    size_t substring_pos = std::string::npos;
-    while ( ( substring_pos = input.find( delimiter ) ) != std::string::npos ) {
-        list.push_back( input.substr( 0, substring_pos ) );
-        input.erase( 0, substring_pos + delimiter.length( ) );
+    for ( auto token : split_range( input, delimiter ) ) {
+        list.emplace_back( token );
     }
-    list.push_back( input.substr( 0, input.length( ) ) );
     return list;
 }
 
@@ -63,11 +227,21 @@ std::vector<std::string> split( std::string &input, const std::string &delimiter
  * @param input 
  * @param substring 
  * @return 
+ * @note single pass: text that only forms the substring once another match is removed is left alone
 */
 inline std::string &strip( std::string &input, const std::string &substring ) {
+    if ( substring.empty( ) ) {
+        return input;
+    }
+    std::string output;
+    output.reserve( input.size( ) );
+    size_t start = 0;
     size_t substring_pos = std::string::npos;
-    while ( ( substring_pos = input.find( substring ) ) != std::string::npos ) {
-        input.erase( substring_pos, substring.length( ) );
+    while ( ( substring_pos = input.find( substring, start ) ) != std::string::npos ) {
+        output.append( input, start, substring_pos - start );
+        start = substring_pos + substring.length( );
     }
+    output.append( input, start );
+    input.swap( output );
     return input;
 }
\ No newline at end of file
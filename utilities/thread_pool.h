@@ -0,0 +1,155 @@
+/*! \file thread_pool.h
+*
+*  \brief fixed size pool of worker threads that run queued tasks
+*
+*
+*  \author Graham Riches
+*/
+
+#pragma once
+
+/********************************** Includes *******************************************/
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+/************************************ Types ********************************************/
+/**
+ * @brief fixed size thread pool. Tasks are run in the order they are submitted and each one hands its
+ *        result (or exception) back through a future. The destructor finishes any queued work before joining.
+*/
+class ThreadPool {
+  public:
+    /**
+     * @brief start the worker threads
+     * @param thread_count number of workers. Defaults to one per hardware thread (at least one)
+    */
+    explicit ThreadPool( std::size_t thread_count = std::thread::hardware_concurrency( ) ) {
+        thread_count = std::max<std::size_t>( thread_count, 1 );
+        this->workers.reserve( thread_count );
+        for ( std::size_t i = 0; i < thread_count; i++ ) {
+            this->workers.emplace_back( [this]( ) { this->run_worker( ); } );
+        }
+    }
+
+    ThreadPool( const ThreadPool & ) = delete;
+    ThreadPool &operator=( const ThreadPool & ) = delete;
+
+    ~ThreadPool( ) {
+        {
+            std::lock_guard<std::mutex> lock( this->queue_mutex );
+            this->stopping = true;
+        }
+        this->wake.notify_all( );
+        for ( auto &worker : this->workers ) {
+            worker.join( );
+        }
+    }
+
+    /**
+     * @brief get the number of worker threads
+     * @return thread count
+    */
+    std::size_t size( void ) const {
+        return this->workers.size( );
+    }
+
+    /**
+     * @brief queue a task to run on one of the workers
+     * @tparam Callable any callable taking no arguments
+     * @param task the task
+     * @return future holding the result of the task
+    */
+    template <typename Callable>
+    auto submit( Callable &&task ) -> std::future<std::invoke_result_t<Callable>> {
+        using Result = std::invoke_result_t<Callable>;
+        auto packaged = std::make_shared<std::packaged_task<Result( )>>( std::forward<Callable>( task ) );
+        auto result = packaged->get_future( );
+        {
+            std::lock_guard<std::mutex> lock( this->queue_mutex );
+            this->tasks.emplace( [packaged]( ) { ( *packaged )( ); } );
+        }
+        this->wake.notify_one( );
+        return result;
+    }
+
+    /**
+     * @brief call a function on every index in [0, count) using the pool and wait for them all to finish
+     * @details the indices are cut into one contiguous block per worker, so the callable should be cheap
+     *          enough per index that a block is worth a task. Every block is waited on before anything is
+     *          rethrown, so the callable is never used after this returns
+     * @tparam Callable void(std::size_t). Must be safe to call from several threads at once
+     * @param count number of indices
+     * @param callable the function to call
+     * @throws the first exception thrown by a block, once every block has finished
+     * @warning don't call this from inside a task running on the same pool: the calling worker blocks waiting
+     *          on blocks that may be queued behind it, which deadlocks once every worker is waiting
+    */
+    template <typename Callable>
+    void parallel_for( std::size_t count, Callable &&callable ) {
+        const std::size_t blocks = std::min( count, this->size( ) );
+        std::vector<std::future<void>> pending;
+        pending.reserve( blocks );
+        auto wait_for_all = [&pending]( ) {
+            for ( auto &block : pending ) {
+                block.wait( );
+            }
+        };
+
+        try {
+            for ( std::size_t block = 0; block < blocks; block++ ) {
+                const std::size_t first = count * block / blocks;
+                const std::size_t last = count * ( block + 1 ) / blocks;
+                pending.push_back( this->submit( [first, last, &callable]( ) {
+                    for ( std::size_t i = first; i < last; i++ ) {
+                        callable( i );
+                    }
+                } ) );
+            }
+        } catch ( ... ) {
+            wait_for_all( );
+            throw;
+        }
+
+        wait_for_all( );
+        for ( auto &block : pending ) {
+            block.get( );
+        }
+    }
+
+  private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void( )>> tasks;
+    std::mutex queue_mutex;
+    std::condition_variable wake;
+    bool stopping{ false };
+
+    /**
+     * @brief worker loop: run tasks until the pool is stopping and the queue is empty
+    */
+    void run_worker( void ) {
+        while ( true ) {
+            std::function<void( )> task;
+            {
+                std::unique_lock<std::mutex> lock( this->queue_mutex );
+                this->wake.wait( lock, [this]( ) { return this->stopping || !this->tasks.empty( ); } );
+                if ( this->stopping && this->tasks.empty( ) ) {
+                    return;
+                }
+                task = std::move( this->tasks.front( ) );
+                this->tasks.pop( );
+            }
+            task( );
+        }
+    }
+};